@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+#include "btree.hpp"
+#include "splay_tree.hpp"
+
+/*
+ * сравнение движков SplayTree и BTree на разных нагрузках: равномерный и Ципфов поиск, поиск по малому рабочему
+ * множеству, последовательный обход ключей, смешанные добавления и удаления; BTree отдельно проверяется на чтении
+ * из нескольких потоков
+ * аргументы (необязательные): число ключей (по умолчанию 1000000) и максимальное число потоков
+ */
+
+constexpr size_t operations = 2000000;
+
+std::vector<int64_t> uniform_trace(size_t keys) {
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int64_t> uniform(0, static_cast<int64_t>(keys) - 1);
+    std::vector<int64_t> trace(operations);
+    for (auto &key: trace) {
+        key = uniform(gen);
+    }
+    return trace;
+}
+
+std::vector<int64_t> zipf_trace(size_t keys) {
+    /*
+     * последовательность ключей по закону Ципфа с показателем 1, ранги перемешаны
+     */
+    std::vector<double> cdf(keys);
+    double total = 0;
+    for (size_t i = 0; i < keys; ++i) {
+        total += 1.0 / static_cast<double>(i + 1);
+        cdf[i] = total;
+    }
+    std::vector<int64_t> ranked(keys);
+    for (size_t i = 0; i < keys; ++i) {
+        ranked[i] = static_cast<int64_t>(i);
+    }
+    std::mt19937_64 gen(42);
+    std::shuffle(ranked.begin(), ranked.end(), gen);
+    std::uniform_real_distribution<double> uniform(0, total);
+    std::vector<int64_t> trace(operations);
+    for (auto &key: trace) {
+        key = ranked[std::lower_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin()];
+    }
+    return trace;
+}
+
+std::vector<int64_t> hot_trace(size_t keys) {
+    /*
+     * поиск по небольшому рабочему множеству из 16 ключей, разбросанных по всему дереву
+     */
+    std::vector<int64_t> trace(operations);
+    for (size_t i = 0; i < operations; ++i) {
+        trace[i] = static_cast<int64_t>((i % 16) * (keys / 16));
+    }
+    return trace;
+}
+
+std::vector<int64_t> sequential_trace(size_t keys) {
+    std::vector<int64_t> trace(operations);
+    for (size_t i = 0; i < operations; ++i) {
+        trace[i] = static_cast<int64_t>(i % keys);
+    }
+    return trace;
+}
+
+template<class Tree>
+void fill(Tree &tree, size_t keys) {
+    std::vector<int64_t> order(keys);
+    for (size_t i = 0; i < keys; ++i) {
+        order[i] = static_cast<int64_t>(i);
+    }
+    std::mt19937_64 gen(7);
+    std::shuffle(order.begin(), order.end(), gen);
+    for (auto key: order) {
+        tree.add(key, "value");
+    }
+}
+
+template<class Tree>
+double searches(Tree &tree, const std::vector<int64_t> &trace) {
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (auto key: trace) {
+        found += tree.find(key) != nullptr;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (found != trace.size()) {
+        std::cerr << "lost keys\n";
+    }
+    return elapsed.count();
+}
+
+template<class Tree>
+double churn(Tree &tree, size_t keys) {
+    /*
+     * удаление и повторное добавление случайных ключей
+     */
+    std::mt19937_64 gen(13);
+    std::uniform_int_distribution<int64_t> uniform(0, static_cast<int64_t>(keys) - 1);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < operations / 2; ++i) {
+        auto key = uniform(gen);
+        tree.remove(key);
+        tree.add(key, "value");
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+double shared_reads(const BTree<int64_t, std::string> &tree, const std::vector<int64_t> &trace, size_t threads) {
+    /*
+     * каждый поток выполняет свою долю поисков по общему дереву без блокировок
+     */
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&tree, &trace, t, threads] {
+            size_t found = 0;
+            for (size_t i = t; i < trace.size(); i += threads) {
+                found += tree.find(trace[i]) != nullptr;
+            }
+            if (!found) {
+                std::cerr << "lost keys\n";
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char *argv[]) {
+    size_t keys = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t max_threads = argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    SplayTree<int64_t, std::string> splay;
+    BTree<int64_t, std::string> btree;
+    fill(splay, keys);
+    fill(btree, keys);
+
+    std::vector<std::pair<std::string, std::vector<int64_t>>> traces;
+    traces.emplace_back("uniform search", uniform_trace(keys));
+    traces.emplace_back("zipf search", zipf_trace(keys));
+    traces.emplace_back("hot set search", hot_trace(keys));
+    traces.emplace_back("sequential search", sequential_trace(keys));
+    std::cout << std::setw(20) << "workload" << std::setw(12) << "splay, s" << std::setw(12) << "btree, s" << '\n';
+    std::cout << std::fixed << std::setprecision(3);
+    for (auto &trace: traces) {
+        std::cout << std::setw(20) << trace.first << std::setw(12) << searches(splay, trace.second)
+                  << std::setw(12) << searches(btree, trace.second) << '\n';
+    }
+    std::cout << std::setw(20) << "remove + add" << std::setw(12) << churn(splay, keys) << std::setw(12)
+              << churn(btree, keys) << '\n';
+
+    std::cout << "\nbtree uniform search from several threads\n" << std::setw(8) << "threads" << std::setw(12)
+              << "seconds" << '\n';
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        std::cout << std::setw(8) << threads << std::setw(12) << shared_reads(btree, traces.front().second, threads)
+                  << '\n';
+    }
+    return 0;
+}
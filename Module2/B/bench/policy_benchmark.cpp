@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+
+#include "splay_tree.hpp"
+
+/*
+ * сравнение политик splay на поиске с распределением Ципфа: время и число поворотов
+ * аргументы (необязательные): показатель распределения (по умолчанию 1.0) и число ключей
+ */
+
+constexpr size_t searches = 2000000;
+
+std::vector<int64_t> zipf_trace(size_t keys, double exponent) {
+    /*
+     * последовательность ключей по закону Ципфа, ранги перемешаны, чтобы популярные ключи не были соседними
+     */
+    std::vector<double> cdf(keys);
+    double total = 0;
+    for (size_t i = 0; i < keys; ++i) {
+        total += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+        cdf[i] = total;
+    }
+    std::vector<int64_t> ranked(keys);
+    for (size_t i = 0; i < keys; ++i) {
+        ranked[i] = static_cast<int64_t>(i);
+    }
+    std::mt19937_64 gen(42);
+    std::shuffle(ranked.begin(), ranked.end(), gen);
+    std::uniform_real_distribution<double> uniform(0, total);
+    std::vector<int64_t> trace(searches);
+    for (auto &key: trace) {
+        key = ranked[std::lower_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin()];
+    }
+    return trace;
+}
+
+template<class Policy>
+void run(const std::string &name, const std::vector<int64_t> &trace, size_t keys) {
+    std::vector<std::pair<int64_t, std::string>> items;
+    for (size_t i = 0; i < keys; ++i) {
+        items.emplace_back(static_cast<int64_t>(i), "value");
+    }
+    auto tree = SplayTree<int64_t, std::string, Policy>::build(items.begin(), items.end());
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (auto key: trace) {
+        found += tree.search(key).first;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << std::setw(22) << name << std::fixed << std::setprecision(3) << std::setw(10) << elapsed.count()
+              << std::setw(14) << tree.rotations() << std::setw(10) << found << '\n';
+}
+
+int main(int argc, char *argv[]) {
+    double exponent = argc > 1 ? std::stod(argv[1]) : 1.0;
+    size_t keys = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    auto trace = zipf_trace(keys, exponent);
+    std::cout << std::setw(22) << "policy" << std::setw(10) << "seconds" << std::setw(14) << "rotations"
+              << std::setw(10) << "found" << '\n';
+    run<BottomUpSplay>("full", trace, keys);
+    run<TopDownSplay>("top-down", trace, keys);
+    run<SemiSplay>("semi", trace, keys);
+    run<DepthThresholdSplay<8>>("depth > 8", trace, keys);
+    run<DepthThresholdSplay<16>>("depth > 16", trace, keys);
+    run<RandomSplay<std::ratio<1, 2>>>("random p=1/2", trace, keys);
+    run<RandomSplay<std::ratio<1, 10>>>("random p=1/10", trace, keys);
+    return 0;
+}
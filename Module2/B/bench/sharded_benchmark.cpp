@@ -0,0 +1,101 @@
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "sharded_splay_tree.hpp"
+
+/*
+ * сравнение пропускной способности одного SplayTree за мьютексом и ShardedSplayTree при росте числа потоков
+ * смесь операций: 80% search, 10% add, 10% delete по равномерным ключам
+ */
+
+constexpr int64_t key_range = 1 << 20;
+constexpr size_t ops_per_thread = 200000;
+
+class LockedSplayTree {
+public:
+    void add(int64_t key, const std::string &value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tree.add(key, value);
+    }
+
+    std::pair<bool, std::string> search(int64_t key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree.search(key);
+    }
+
+    void remove(int64_t key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tree.remove(key);
+    }
+
+private:
+    std::mutex mutex;
+    SplayTree<> tree;
+};
+
+template<class Map>
+double run(Map &map, size_t threads) {
+    /*
+     * запуск смеси операций в threads потоках, возвращает млн операций в секунду
+     */
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&map, t]() {
+            std::mt19937_64 gen(t + 1);
+            std::uniform_int_distribution<int64_t> keys(0, key_range - 1);
+            for (size_t i = 0; i < ops_per_thread; ++i) {
+                auto key = keys(gen);
+                auto op = gen() % 10;
+                try {
+                    if (op == 0) {
+                        map.add(key, "value");
+                    } else if (op == 1) {
+                        map.remove(key);
+                    } else {
+                        map.search(key);
+                    }
+                } catch (std::logic_error &) {
+                }
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(threads * ops_per_thread) / elapsed.count() / 1e6;
+}
+
+template<class Map>
+void fill(Map &map) {
+    /*
+     * заполнение половиной ключей диапазона в перемешанном порядке
+     */
+    for (int64_t key = 0; key < key_range; key += 2) {
+        map.add(key * 7919 % key_range, "value");
+    }
+}
+
+int main(int argc, char *argv[]) {
+    /*
+     * необязательный аргумент - макс. число потоков (по умолчанию число ядер)
+     */
+    size_t max_threads = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "locked Mops/s" << std::setw(15) << "sharded Mops/s"
+              << '\n';
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        LockedSplayTree locked;
+        ShardedSplayTree<> sharded(4 * max_threads);
+        fill(locked);
+        fill(sharded);
+        auto locked_rate = run(locked, threads);
+        auto sharded_rate = run(sharded, threads);
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2) << std::setw(14) << locked_rate
+                  << std::setw(15) << sharded_rate << '\n';
+    }
+    return 0;
+}
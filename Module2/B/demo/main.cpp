@@ -1,6 +1,15 @@
+#include <btree.hpp>
 #include <splay_tree.hpp>
 
-int main() {
-    handler<std::ostream, std::istream>(std::cout, std::cin);
+int main(int argc, char *argv[]) {
+    /*
+     * движок словаря выбирается аргументом: btree - B-дерево, иначе - splay-дерево
+     */
+    if (argc > 1 && std::string(argv[1]) == "btree") {
+        BTree<int64_t, std::string> tree;
+        run_commands(tree, std::cout, std::cin);
+    } else {
+        handler<std::ostream, std::istream>(std::cout, std::cin);
+    }
     return 0;
 }
@@ -0,0 +1,681 @@
+#ifndef SPLAYTREE_BTREE_HPP
+#define SPLAYTREE_BTREE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "node_pool.hpp"
+
+template<class K = int64_t, class V = std::string, size_t Degree = std::max<size_t>(2, 64 / sizeof(K))>
+class BTree {
+    /*
+     * B-дерево минимальной степени Degree: в узле от Degree - 1 до 2 * Degree - 1 ключей (в корне от 1), все листья
+     * на одной глубине
+     * ключи узла лежат подряд и занимают пару кэш-линий, значения вынесены в отдельный массив, поэтому поиск
+     * читает O(log n / log Degree) узлов вместо O(log n) и не трогает значения до последнего шага
+     * поиск не меняет дерево, поэтому константные методы можно вызывать из нескольких потоков одновременно
+     * интерфейс совпадает с SplayTree (add, set, remove, search, min, max, ранги), K и V должны иметь конструктор
+     * по умолчанию
+     */
+    static_assert(Degree >= 2, "Minimum degree of B-tree must be at least 2");
+
+    struct Node;
+
+public:
+    template<bool Const>
+    class Iterator;
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    BTree() noexcept: root(nullptr) {}
+
+    BTree(const BTree &) = delete;
+
+    BTree &operator=(const BTree &) = delete;
+
+    ~BTree() noexcept {
+        clear();
+    }
+
+    void add(const K &key, const V &value) {
+        /*
+         * метод добавления пары, если ключ уже есть, вызывает исключение
+         */
+        _insert(key, value);
+    }
+
+    void add(K &&key, V &&value) {
+        /*
+         * добавление с переносом ключа и значения в узел без копирования
+         */
+        _insert(std::move(key), std::move(value));
+    }
+
+    void set(const K &key, const V &new_value) {
+        /*
+         * метод изменения значения по ключу, если ключа нет, вызывает исключение
+         */
+        _find_existing(key) = new_value;
+    }
+
+    void set(const K &key, V &&new_value) {
+        /*
+         * изменение значения с переносом нового значения в узел
+         */
+        _find_existing(key) = std::move(new_value);
+    }
+
+    [[nodiscard]] std::pair<bool, V> search(const K &key) const {
+        /*
+         * метод поиска по ключу в формате SplayTree::search
+         */
+        auto value = find(key);
+        if (value) {
+            return std::make_pair(true, *value);
+        }
+        return std::make_pair(false, V());
+    }
+
+    V *find(const K &key) noexcept {
+        /*
+         * метод поиска по ключу без копирования
+         * возвращает указатель на значение в узле или nullptr, если ключа нет
+         * указатель действителен до следующего изменения дерева
+         */
+        auto position = _find(key);
+        return position.first ? &position.first->values[position.second] : nullptr;
+    }
+
+    [[nodiscard]] const V *find(const K &key) const noexcept {
+        auto position = _find(key);
+        return position.first ? &position.first->values[position.second] : nullptr;
+    }
+
+    void remove(const K &key) {
+        /*
+         * метод удаления по ключу, если ключа нет, вызывает исключение
+         * удаление идет за один спуск: перед переходом в ребенка с минимальным числом ключей он пополняется
+         * от соседа или сливается с ним
+         */
+        if (!find(key)) {
+            throw std::logic_error{"Node with this key doesn't exist"};
+        }
+        _remove(root, key);
+        if (!root->count) {
+            auto old_root = root;
+            root = root->leaf ? nullptr : root->children[0];
+            if (root) {
+                root->parent = nullptr;
+            }
+            pool.destroy(old_root);
+        }
+    }
+
+    std::pair<K, V> min() const {
+        /*
+         * метод получения пары с минимальным ключом, для пустого дерева вызывает исключение
+         */
+        if (empty()) {
+            throw std::logic_error{"Can`t find minimum element in empty tree"};
+        }
+        auto min = find_min();
+        return std::make_pair(min.key(), min.value());
+    }
+
+    std::pair<K, V> max() const {
+        /*
+         * метод получения пары с максимальным ключом, для пустого дерева вызывает исключение
+         */
+        if (empty()) {
+            throw std::logic_error{"Can`t find maximum element in empty tree"};
+        }
+        auto max = find_max();
+        return std::make_pair(max.key(), max.value());
+    }
+
+    iterator find_min() noexcept {
+        /*
+         * метод получения пары с минимальным ключом без копирования, для пустого дерева возвращает end()
+         */
+        return begin();
+    }
+
+    [[nodiscard]] const_iterator find_min() const noexcept {
+        return begin();
+    }
+
+    iterator find_max() noexcept {
+        /*
+         * метод получения пары с максимальным ключом без копирования, для пустого дерева возвращает end()
+         */
+        auto x = _rightmost(root);
+        return x ? iterator(x, x->count - 1) : end();
+    }
+
+    [[nodiscard]] const_iterator find_max() const noexcept {
+        auto x = _rightmost(root);
+        return x ? const_iterator(x, x->count - 1) : end();
+    }
+
+    [[nodiscard]] size_t rank(const K &key) const noexcept {
+        /*
+         * метод получения ранга ключа - числа ключей дерева, меньших заданного
+         */
+        return _rank(key, false);
+    }
+
+    std::pair<K, V> select(size_t k) const {
+        /*
+         * метод получения k-й по возрастанию пары (нумерация с 0)
+         * если k не меньше размера дерева, вызывает исключение
+         */
+        if (k >= size()) {
+            throw std::out_of_range{"Rank is out of tree"};
+        }
+        auto x = root;
+        for (;;) {
+            size_t i = 0;
+            for (; i < x->count; ++i) {
+                auto left = _size_of(x->children[i]);
+                if (k < left) {
+                    break;
+                }
+                if (k == left) {
+                    return std::make_pair(x->keys[i], x->values[i]);
+                }
+                k -= left + 1;
+            }
+            x = x->children[i];
+        }
+    }
+
+    [[nodiscard]] size_t count_range(const K &lo, const K &hi) const noexcept {
+        /*
+         * метод подсчета ключей из отрезка [lo, hi]
+         */
+        if (hi < lo) {
+            return 0;
+        }
+        auto less = _rank(lo, false);
+        return _rank(hi, true) - less;
+    }
+
+    iterator begin() noexcept {
+        auto x = _leftmost(root);
+        return x ? iterator(x, 0) : end();
+    }
+
+    iterator end() noexcept {
+        return iterator(nullptr, 0);
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+        auto x = _leftmost(root);
+        return x ? const_iterator(x, 0) : end();
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(nullptr, 0);
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        /*
+         * метод получения числа пар в дереве
+         */
+        return _size_of(root);
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        /*
+         * метод проверки дерева на пустоту
+         */
+        return !root;
+    }
+
+    void clear() noexcept {
+        /*
+         * метод очищения дерева
+         */
+        if (empty()) {
+            return;
+        }
+        std::vector<Node *> stack{root};
+        while (!stack.empty()) {
+            auto x = stack.back();
+            stack.pop_back();
+            if (!x->leaf) {
+                stack.insert(stack.end(), x->children.begin(), x->children.begin() + x->count + 1);
+            }
+            x->~Node();
+        }
+        pool.release();
+        root = nullptr;
+    }
+
+    template<class Key, class Value, size_t D>
+    friend std::ostream &operator<<(std::ostream &out, const BTree<Key, Value, D> &tree) noexcept;
+
+private:
+    static constexpr size_t max_keys = 2 * Degree - 1;
+
+    struct Node {
+        /*
+         * узел дерева: число ключей, размер поддерева, ключи, дети и значения
+         * поля, нужные при спуске, идут первыми
+         */
+        size_t count;
+        size_t size;
+        bool leaf;
+        Node *parent;
+        std::array<K, max_keys> keys;
+        std::array<Node *, max_keys + 1> children;
+        std::array<V, max_keys> values;
+
+        explicit Node(bool is_leaf, Node *p = nullptr) : count(0), size(0), leaf(is_leaf), parent(p), keys(),
+                                                         children(), values() {}
+
+        size_t index_of(const Node *child) const noexcept {
+            /*
+             * позиция ребенка среди детей узла
+             */
+            return std::find(children.begin(), children.begin() + count + 1, child) - children.begin();
+        }
+
+        void update() noexcept {
+            /*
+             * пересчет размера поддерева по детям
+             */
+            size = count;
+            if (!leaf) {
+                for (size_t i = 0; i <= count; ++i) {
+                    size += children[i]->size;
+                }
+            }
+        }
+    };
+
+    using Pool = NodePool<Node>;
+
+    Node *root;
+    Pool pool;
+
+    static size_t _size_of(const Node *x) noexcept {
+        return x ? x->size : 0;
+    }
+
+    static Node *_leftmost(Node *x) noexcept {
+        while (x && !x->leaf) {
+            x = x->children[0];
+        }
+        return x;
+    }
+
+    static Node *_rightmost(Node *x) noexcept {
+        while (x && !x->leaf) {
+            x = x->children[x->count];
+        }
+        return x;
+    }
+
+    std::pair<Node *, size_t> _find(const K &key) const noexcept {
+        /*
+         * поиск узла и позиции ключа в нем, (nullptr, 0) - если ключа нет
+         */
+        auto x = root;
+        while (x) {
+            auto i = std::lower_bound(x->keys.begin(), x->keys.begin() + x->count, key) - x->keys.begin();
+            if (i < static_cast<ptrdiff_t>(x->count) && !(key < x->keys[i])) {
+                return std::make_pair(x, static_cast<size_t>(i));
+            }
+            x = x->leaf ? nullptr : x->children[i];
+        }
+        return std::make_pair(nullptr, 0);
+    }
+
+    V &_find_existing(const K &key) {
+        /*
+         * значение по ключу для изменения, если ключа нет, вызывает исключение
+         */
+        auto value = find(key);
+        if (!value) {
+            throw std::logic_error{"Node with this key doesn't exist"};
+        }
+        return *value;
+    }
+
+    size_t _rank(const K &key, bool inclusive) const noexcept {
+        /*
+         * число ключей, меньших key (inclusive - не больших key)
+         */
+        size_t rank = 0;
+        for (auto x = root; x;) {
+            size_t i = inclusive
+                       ? std::upper_bound(x->keys.begin(), x->keys.begin() + x->count, key) - x->keys.begin()
+                       : std::lower_bound(x->keys.begin(), x->keys.begin() + x->count, key) - x->keys.begin();
+            rank += i;
+            if (x->leaf) {
+                break;
+            }
+            for (size_t j = 0; j < i; ++j) {
+                rank += x->children[j]->size;
+            }
+            x = x->children[i];
+        }
+        return rank;
+    }
+
+    template<class Key, class Value>
+    void _insert(Key &&key, Value &&value) {
+        /*
+         * вставка за один спуск: полный узел на пути расщепляется до перехода в него, поэтому подъем не нужен
+         */
+        if (find(key)) {
+            throw std::logic_error{"Node with this key have already added"};
+        }
+        if (empty()) {
+            root = pool.create(true);
+        } else if (root->count == max_keys) {
+            auto new_root = pool.create(false);
+            new_root->children[0] = root;
+            new_root->size = root->size;
+            root->parent = new_root;
+            root = new_root;
+            _split_child(root, 0);
+        }
+        auto x = root;
+        for (;;) {
+            ++x->size;
+            size_t i = std::upper_bound(x->keys.begin(), x->keys.begin() + x->count, key) - x->keys.begin();
+            if (x->leaf) {
+                std::move_backward(x->keys.begin() + i, x->keys.begin() + x->count,
+                                   x->keys.begin() + x->count + 1);
+                std::move_backward(x->values.begin() + i, x->values.begin() + x->count,
+                                   x->values.begin() + x->count + 1);
+                x->keys[i] = std::forward<Key>(key);
+                x->values[i] = std::forward<Value>(value);
+                ++x->count;
+                return;
+            }
+            if (x->children[i]->count == max_keys) {
+                _split_child(x, i);
+                if (x->keys[i] < key) {
+                    ++i;
+                }
+            }
+            x = x->children[i];
+        }
+    }
+
+    void _split_child(Node *x, size_t i) {
+        /*
+         * расщепление полного ребенка x->children[i]: средний ключ поднимается в x, правая половина уходит в новый
+         * узел
+         */
+        auto y = x->children[i];
+        auto z = pool.create(y->leaf, x);
+        z->count = Degree - 1;
+        std::move(y->keys.begin() + Degree, y->keys.end(), z->keys.begin());
+        std::move(y->values.begin() + Degree, y->values.end(), z->values.begin());
+        if (!y->leaf) {
+            std::copy(y->children.begin() + Degree, y->children.end(), z->children.begin());
+            for (size_t j = 0; j < Degree; ++j) {
+                z->children[j]->parent = z;
+            }
+        }
+        y->count = Degree - 1;
+        std::move_backward(x->keys.begin() + i, x->keys.begin() + x->count, x->keys.begin() + x->count + 1);
+        std::move_backward(x->values.begin() + i, x->values.begin() + x->count, x->values.begin() + x->count + 1);
+        std::copy_backward(x->children.begin() + i + 1, x->children.begin() + x->count + 1,
+                           x->children.begin() + x->count + 2);
+        x->keys[i] = std::move(y->keys[Degree - 1]);
+        x->values[i] = std::move(y->values[Degree - 1]);
+        x->children[i + 1] = z;
+        ++x->count;
+        y->update();
+        z->update();
+    }
+
+    void _remove(Node *x, const K &key) {
+        /*
+         * удаление ключа из поддерева x, в котором ключей не меньше Degree (кроме корня)
+         * глубина рекурсии равна высоте дерева
+         */
+        size_t i = std::lower_bound(x->keys.begin(), x->keys.begin() + x->count, key) - x->keys.begin();
+        bool here = i < x->count && !(key < x->keys[i]);
+        if (x->leaf) {
+            std::move(x->keys.begin() + i + 1, x->keys.begin() + x->count, x->keys.begin() + i);
+            std::move(x->values.begin() + i + 1, x->values.begin() + x->count, x->values.begin() + i);
+            --x->count;
+            x->update();
+            return;
+        }
+        if (here) {
+            auto left = x->children[i];
+            auto right = x->children[i + 1];
+            if (left->count >= Degree) {
+                auto predecessor = _rightmost(left);
+                x->keys[i] = predecessor->keys[predecessor->count - 1];
+                x->values[i] = std::move(predecessor->values[predecessor->count - 1]);
+                _remove(left, x->keys[i]);
+            } else if (right->count >= Degree) {
+                auto successor = _leftmost(right);
+                x->keys[i] = successor->keys[0];
+                x->values[i] = std::move(successor->values[0]);
+                _remove(right, x->keys[i]);
+            } else {
+                _merge(x, i);
+                _remove(left, key);
+            }
+            x->update();
+            return;
+        }
+        auto child = x->children[i];
+        if (child->count < Degree) {
+            if (i > 0 && x->children[i - 1]->count >= Degree) {
+                _borrow_left(x, i);
+            } else if (i < x->count && x->children[i + 1]->count >= Degree) {
+                _borrow_right(x, i);
+            } else if (i < x->count) {
+                _merge(x, i);
+            } else {
+                child = x->children[i - 1];
+                _merge(x, i - 1);
+            }
+        }
+        _remove(child, key);
+        x->update();
+    }
+
+    void _borrow_left(Node *x, size_t i) {
+        /*
+         * перенос ключа из левого соседа ребенка x->children[i] через разделяющий ключ x
+         */
+        auto child = x->children[i];
+        auto sibling = x->children[i - 1];
+        std::move_backward(child->keys.begin(), child->keys.begin() + child->count,
+                           child->keys.begin() + child->count + 1);
+        std::move_backward(child->values.begin(), child->values.begin() + child->count,
+                           child->values.begin() + child->count + 1);
+        child->keys[0] = std::move(x->keys[i - 1]);
+        child->values[0] = std::move(x->values[i - 1]);
+        if (!child->leaf) {
+            std::copy_backward(child->children.begin(), child->children.begin() + child->count + 1,
+                               child->children.begin() + child->count + 2);
+            child->children[0] = sibling->children[sibling->count];
+            child->children[0]->parent = child;
+        }
+        ++child->count;
+        x->keys[i - 1] = std::move(sibling->keys[sibling->count - 1]);
+        x->values[i - 1] = std::move(sibling->values[sibling->count - 1]);
+        --sibling->count;
+        sibling->update();
+        child->update();
+    }
+
+    void _borrow_right(Node *x, size_t i) {
+        /*
+         * перенос ключа из правого соседа ребенка x->children[i] через разделяющий ключ x
+         */
+        auto child = x->children[i];
+        auto sibling = x->children[i + 1];
+        child->keys[child->count] = std::move(x->keys[i]);
+        child->values[child->count] = std::move(x->values[i]);
+        if (!child->leaf) {
+            child->children[child->count + 1] = sibling->children[0];
+            child->children[child->count + 1]->parent = child;
+            std::copy(sibling->children.begin() + 1, sibling->children.begin() + sibling->count + 1,
+                      sibling->children.begin());
+        }
+        ++child->count;
+        x->keys[i] = std::move(sibling->keys[0]);
+        x->values[i] = std::move(sibling->values[0]);
+        std::move(sibling->keys.begin() + 1, sibling->keys.begin() + sibling->count, sibling->keys.begin());
+        std::move(sibling->values.begin() + 1, sibling->values.begin() + sibling->count, sibling->values.begin());
+        --sibling->count;
+        sibling->update();
+        child->update();
+    }
+
+    void _merge(Node *x, size_t i) {
+        /*
+         * слияние детей x->children[i] и x->children[i + 1] (в каждом Degree - 1 ключей) с разделяющим ключом x
+         */
+        auto left = x->children[i];
+        auto right = x->children[i + 1];
+        left->keys[Degree - 1] = std::move(x->keys[i]);
+        left->values[Degree - 1] = std::move(x->values[i]);
+        std::move(right->keys.begin(), right->keys.begin() + right->count, left->keys.begin() + Degree);
+        std::move(right->values.begin(), right->values.begin() + right->count, left->values.begin() + Degree);
+        if (!left->leaf) {
+            std::copy(right->children.begin(), right->children.begin() + right->count + 1,
+                      left->children.begin() + Degree);
+            for (size_t j = Degree; j <= max_keys; ++j) {
+                left->children[j]->parent = left;
+            }
+        }
+        left->count = max_keys;
+        std::move(x->keys.begin() + i + 1, x->keys.begin() + x->count, x->keys.begin() + i);
+        std::move(x->values.begin() + i + 1, x->values.begin() + x->count, x->values.begin() + i);
+        std::copy(x->children.begin() + i + 2, x->children.begin() + x->count + 1, x->children.begin() + i + 1);
+        --x->count;
+        left->update();
+        pool.destroy(right);
+    }
+};
+
+template<class K, class V, size_t Degree>
+template<bool Const>
+class BTree<K, V, Degree>::Iterator {
+    /*
+     * итератор по парам в порядке возрастания ключей: узел и позиция ключа в нем
+     * переход к следующему ключу поднимается по указателям на родителя, полный обход - O(n)
+     */
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<const K, V>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const K &, std::conditional_t<Const, const V &, V &>>;
+    using pointer = void;
+
+    Iterator() noexcept: node(nullptr), index(0) {}
+
+    template<bool C = Const, class = std::enable_if_t<C>>
+    Iterator(const Iterator<false> &other) noexcept: node(other.node), index(other.index) {}
+
+    reference operator*() const noexcept {
+        return reference(node->keys[index], node->values[index]);
+    }
+
+    const K &key() const noexcept {
+        return node->keys[index];
+    }
+
+    std::conditional_t<Const, const V &, V &> value() const noexcept {
+        return node->values[index];
+    }
+
+    Iterator &operator++() noexcept {
+        if (!node->leaf) {
+            node = _leftmost(node->children[index + 1]);
+            index = 0;
+            return *this;
+        }
+        if (++index < node->count) {
+            return *this;
+        }
+        while (node->parent) {
+            auto i = node->parent->index_of(node);
+            node = node->parent;
+            if (i < node->count) {
+                index = i;
+                return *this;
+            }
+        }
+        node = nullptr;
+        index = 0;
+        return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    bool operator==(const Iterator &other) const noexcept {
+        return node == other.node && index == other.index;
+    }
+
+    bool operator!=(const Iterator &other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    friend class BTree;
+    friend class Iterator<!Const>;
+
+    Node *node;
+    size_t index;
+
+    Iterator(Node *n, size_t i) noexcept: node(n), index(i) {}
+};
+
+template<class Key, class Value, size_t D>
+std::ostream &operator<<(std::ostream &out, const BTree<Key, Value, D> &tree) noexcept {
+    /*
+     * вывод дерева по уровням: узел - это его пары в квадратных скобках, узлы одного уровня разделены пробелами
+     */
+    if (tree.empty()) {
+        out << "_\n";
+        return out;
+    }
+    std::vector<const typename BTree<Key, Value, D>::Node *> level{tree.root};
+    while (!level.empty()) {
+        std::vector<const typename BTree<Key, Value, D>::Node *> next;
+        for (size_t j = 0; j < level.size(); ++j) {
+            auto x = level[j];
+            out << (j ? " [" : "[");
+            for (size_t i = 0; i < x->count; ++i) {
+                out << (i ? " " : "") << x->keys[i] << ' ' << x->values[i];
+            }
+            out << ']';
+            if (!x->leaf) {
+                next.insert(next.end(), x->children.begin(), x->children.begin() + x->count + 1);
+            }
+        }
+        out << '\n';
+        level = std::move(next);
+    }
+    return out;
+}
+
+#endif //SPLAYTREE_BTREE_HPP
@@ -0,0 +1,142 @@
+#ifndef SPLAYTREE_FROZEN_TREE_HPP
+#define SPLAYTREE_FROZEN_TREE_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+template<class K = int64_t, class V = std::string>
+class FrozenTree {
+    /*
+     * неизменяемый снимок упорядоченного словаря в раскладке Эйтцингера: ключи лежат в массиве в порядке обхода
+     * в ширину идеально сбалансированного дерева (дети узла k - 2k и 2k + 1), значения - в параллельном массиве
+     * поиск идет без ветвлений по непрерывной памяти и ничего не меняет, поэтому константные методы можно
+     * вызывать из любого числа потоков одновременно
+     */
+public:
+    FrozenTree() noexcept = default;
+
+    template<class InputIt>
+    FrozenTree(InputIt first, InputIt last) {
+        /*
+         * построение снимка из диапазона пар (ключ, значение), упорядоченного строго по возрастанию ключей
+         * если порядок нарушен, вызывает исключение
+         */
+        std::vector<std::pair<K, V>> sorted;
+        for (; first != last; ++first) {
+            auto &&item = *first;
+            if (!sorted.empty() && !(sorted.back().first < item.first)) {
+                throw std::logic_error{"Keys of frozen tree must be strictly increasing"};
+            }
+            sorted.emplace_back(item.first, item.second);
+        }
+        keys.resize(sorted.size() + 1);
+        values.resize(sorted.size() + 1);
+        size_t next = 0;
+        _fill(sorted, next, 1);
+    }
+
+    [[nodiscard]] const V *find(const K &key) const noexcept {
+        /*
+         * метод поиска по ключу
+         * возвращает указатель на значение или nullptr, если ключа нет
+         */
+        auto k = _lower_bound(key);
+        if (k && !(key < keys[k])) {
+            return &values[k];
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] std::pair<bool, V> search(const K &key) const {
+        /*
+         * метод поиска по ключу в формате SplayTree::search
+         */
+        auto value = find(key);
+        if (value) {
+            return std::make_pair(true, *value);
+        }
+        return std::make_pair(false, V());
+    }
+
+    [[nodiscard]] std::pair<K, V> min() const {
+        /*
+         * метод получения пары с минимальным ключом, для пустого снимка вызывает исключение
+         */
+        if (empty()) {
+            throw std::logic_error{"Can`t find minimum element in empty tree"};
+        }
+        size_t k = 1;
+        while (2 * k < keys.size()) {
+            k *= 2;
+        }
+        return std::make_pair(keys[k], values[k]);
+    }
+
+    [[nodiscard]] std::pair<K, V> max() const {
+        /*
+         * метод получения пары с максимальным ключом, для пустого снимка вызывает исключение
+         */
+        if (empty()) {
+            throw std::logic_error{"Can`t find maximum element in empty tree"};
+        }
+        size_t k = 1;
+        while (2 * k + 1 < keys.size()) {
+            k = 2 * k + 1;
+        }
+        return std::make_pair(keys[k], values[k]);
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        /*
+         * метод получения числа пар в снимке
+         */
+        return keys.empty() ? 0 : keys.size() - 1;
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        /*
+         * метод проверки снимка на пустоту
+         */
+        return size() == 0;
+    }
+
+private:
+    std::vector<K> keys;    // ключи в раскладке Эйтцингера, нулевой элемент не используется
+    std::vector<V> values;  // значения в тех же позициях
+
+    void _fill(std::vector<std::pair<K, V>> &sorted, size_t &next, size_t k) {
+        /*
+         * раскладка отсортированного массива: симметричный обход неявного дерева с корнем k
+         * глубина рекурсии - O(log n)
+         */
+        if (k < keys.size()) {
+            _fill(sorted, next, 2 * k);
+            keys[k] = std::move(sorted[next].first);
+            values[k] = std::move(sorted[next].second);
+            ++next;
+            _fill(sorted, next, 2 * k + 1);
+        }
+    }
+
+    [[nodiscard]] size_t _lower_bound(const K &key) const noexcept {
+        /*
+         * индекс первого ключа не меньше key (0, если такого нет)
+         * спуск без ветвлений: на каждом уровне выбирается ребенок по результату сравнения, следующий блок ключей
+         * заранее подгружается в кэш; в конце лишние правые шаги снимаются сдвигом
+         */
+        size_t k = 1;
+        auto n = keys.size();
+        while (k < n) {
+            __builtin_prefetch(keys.data() + std::min(16 * k, n - 1));
+            k = 2 * k + static_cast<size_t>(keys[k] < key);
+        }
+        k >>= __builtin_ctzll(~static_cast<unsigned long long>(k)) + 1;
+        return k;
+    }
+};
+
+#endif //SPLAYTREE_FROZEN_TREE_HPP
@@ -0,0 +1,163 @@
+#ifndef SPLAYTREE_NODE_POOL_HPP
+#define SPLAYTREE_NODE_POOL_HPP
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+template<class T>
+class NodePool {
+public:
+    NodePool() noexcept: free_list(nullptr), free_tail(nullptr), used(0), capacity(0), reserved(0) {}
+
+    NodePool(const NodePool &) = delete;
+
+    NodePool &operator=(const NodePool &) = delete;
+
+    ~NodePool() noexcept {
+        release();
+    }
+
+    template<class... Args>
+    T *create(Args &&... args) {
+        /*
+         * метод создания объекта в пуле: сначала переиспользуется слот из списка свободных, затем берется следующий
+         * слот текущего слаба, и только если он закончился, выделяется новый слаб (вдвое больше предыдущего)
+         */
+        auto slot = _allocate();
+        try {
+            return ::new(static_cast<void *>(slot->storage)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            _deallocate(slot);
+            throw;
+        }
+    }
+
+    void destroy(T *object) noexcept {
+        /*
+         * метод удаления объекта, его слот попадает в список свободных и будет переиспользован
+         */
+        object->~T();
+        _deallocate(reinterpret_cast<Slot *>(object));
+    }
+
+    void reserve(size_t count) {
+        /*
+         * метод подготовки непрерывного участка под count объектов, чтобы следующие count созданий не выделяли память
+         * и шли подряд (используется при массовом построении): эти создания берут слоты текущего слаба, минуя список
+         * свободных; если остатка слаба не хватает, выделяется новый слаб, а остаток уходит в список свободных
+         */
+        if (capacity - used < count) {
+            slabs.emplace_back(new Slot[count]);
+            _retire_rest();
+            capacity = count;
+            used = 0;
+        }
+        reserved = count;
+    }
+
+    void release() noexcept {
+        /*
+         * метод освобождения всех слабов целиком
+         * деструкторы объектов не вызываются - это остается на владельце пула
+         */
+        slabs.clear();
+        free_list = nullptr;
+        free_tail = nullptr;
+        used = 0;
+        capacity = 0;
+        reserved = 0;
+    }
+
+    void merge(NodePool &other) {
+        /*
+         * метод переноса всех слабов other в этот пул, живые объекты other остаются на своих местах
+         * свободные слоты other переходят в список свободных, остаток текущего слаба other не используется
+         */
+        if (&other == this) {
+            return;
+        }
+        slabs.reserve(slabs.size() + other.slabs.size());
+        slabs.insert(slabs.begin(), std::make_move_iterator(other.slabs.begin()),
+                     std::make_move_iterator(other.slabs.end()));
+        if (other.free_list) {
+            if (free_list) {
+                free_tail->next = other.free_list;
+            } else {
+                free_list = other.free_list;
+            }
+            free_tail = other.free_tail;
+        }
+        other.slabs.clear();
+        other.free_list = nullptr;
+        other.free_tail = nullptr;
+        other.used = 0;
+        other.capacity = 0;
+        other.reserved = 0;
+    }
+
+private:
+    union Slot {
+        Slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static constexpr size_t first_slab_size = 16;
+    static constexpr size_t max_slab_size = 4096;
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    Slot *free_list;  // односвязный список освобожденных слотов
+    Slot *free_tail;  // последний слот этого списка (для слияния пулов за O(1))
+    size_t used;      // число занятых слотов в последнем слабе
+    size_t capacity;  // размер последнего слаба
+    size_t reserved;  // число созданий, которые берут слоты последнего слаба подряд (после reserve)
+
+    Slot *_allocate() {
+        /*
+         * выделение слота под один объект
+         */
+        if (reserved) {
+            --reserved;
+            return &slabs.back()[used++];
+        }
+        if (free_list) {
+            auto slot = free_list;
+            free_list = slot->next;
+            if (!free_list) {
+                free_tail = nullptr;
+            }
+            return slot;
+        }
+        if (used == capacity) {
+            auto size = capacity ? std::min(2 * capacity, max_slab_size) : first_slab_size;
+            slabs.emplace_back(new Slot[size]);
+            capacity = size;
+            used = 0;
+        }
+        return &slabs.back()[used++];
+    }
+
+    void _retire_rest() noexcept {
+        /*
+         * перенос неиспользованного остатка предпоследнего слаба в список свободных (новый слаб уже добавлен)
+         */
+        for (; used < capacity; ++used) {
+            _deallocate(&slabs[slabs.size() - 2][used]);
+        }
+    }
+
+    void _deallocate(Slot *slot) noexcept {
+        /*
+         * возврат слота в список свободных
+         */
+        if (!free_list) {
+            free_tail = slot;
+        }
+        slot->next = free_list;
+        free_list = slot;
+    }
+};
+
+#endif //SPLAYTREE_NODE_POOL_HPP
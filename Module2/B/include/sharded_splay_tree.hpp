@@ -0,0 +1,195 @@
+#ifndef SPLAYTREE_SHARDED_SPLAY_TREE_HPP
+#define SPLAYTREE_SHARDED_SPLAY_TREE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "splay_tree.hpp"
+
+template<class K = int64_t, class V = std::string, class Policy = BottomUpSplay>
+class ShardedSplayTree {
+    /*
+     * потокобезопасный словарь из нескольких splay-деревьев (шардов), у каждого свой мьютекс
+     * любое обращение к splay-дереву меняет корень, поэтому одно дерево за одним мьютексом выполняет потоки строго
+     * по очереди; здесь потоки блокируют только свой шард, а локальность splay сохраняется внутри шарда
+     * ключи распределяются по шардам либо по хешу, либо по диапазонам (границы задаются при создании)
+     */
+public:
+    explicit ShardedSplayTree(size_t count = std::max(1u, std::thread::hardware_concurrency())) : shards(count) {
+        /*
+         * хеш-разбиение на count шардов
+         */
+        if (!count) {
+            throw std::invalid_argument{"Number of shards must be positive"};
+        }
+    }
+
+    explicit ShardedSplayTree(std::vector<K> shard_bounds) : shards(shard_bounds.size() + 1),
+                                                             bounds(std::move(shard_bounds)) {
+        /*
+         * разбиение по диапазонам: шард i хранит ключи из [bounds[i - 1], bounds[i]), границы должны строго
+         * возрастать, иначе вызывается исключение
+         */
+        if (std::adjacent_find(bounds.begin(), bounds.end(), [](const K &a, const K &b) {
+            return !(a < b);
+        }) != bounds.end()) {
+            throw std::invalid_argument{"Shard bounds must be strictly increasing"};
+        }
+    }
+
+    void add(const K &key, const V &value) {
+        /*
+         * метод добавления пары, если ключ уже есть, вызывает исключение
+         */
+        auto &shard = _shard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.tree.add(key, value);
+    }
+
+    void set(const K &key, const V &new_value) {
+        /*
+         * метод изменения значения по ключу, если ключа нет, вызывает исключение
+         */
+        auto &shard = _shard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.tree.set(key, new_value);
+    }
+
+    std::pair<bool, V> search(const K &key) {
+        /*
+         * метод поиска по ключу в формате SplayTree::search
+         */
+        auto &shard = _shard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.tree.search(key);
+    }
+
+    void remove(const K &key) {
+        /*
+         * метод удаления по ключу, если ключа нет, вызывает исключение
+         */
+        auto &shard = _shard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.tree.remove(key);
+    }
+
+    std::pair<K, V> min() {
+        /*
+         * метод получения пары с минимальным ключом среди всех шардов
+         * шарды блокируются по очереди, поэтому при параллельных изменениях ответ соответствует состоянию каждого
+         * шарда в момент его просмотра; при разбиении по диапазонам просмотр останавливается на первом непустом шарде
+         */
+        std::pair<K, V> best;
+        bool found = false;
+        for (auto &shard: shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.tree.empty()) {
+                continue;
+            }
+            auto candidate = shard.tree.min();
+            if (!found || candidate.first < best.first) {
+                best = std::move(candidate);
+                found = true;
+            }
+            if (!bounds.empty()) {
+                break;
+            }
+        }
+        if (!found) {
+            throw std::logic_error{"Can`t find minimum element in empty tree"};
+        }
+        return best;
+    }
+
+    std::pair<K, V> max() {
+        /*
+         * метод получения пары с максимальным ключом среди всех шардов (см. min)
+         */
+        std::pair<K, V> best;
+        bool found = false;
+        for (auto shard = shards.rbegin(); shard != shards.rend(); ++shard) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            if (shard->tree.empty()) {
+                continue;
+            }
+            auto candidate = shard->tree.max();
+            if (!found || best.first < candidate.first) {
+                best = std::move(candidate);
+                found = true;
+            }
+            if (!bounds.empty()) {
+                break;
+            }
+        }
+        if (!found) {
+            throw std::logic_error{"Can`t find maximum element in empty tree"};
+        }
+        return best;
+    }
+
+    [[nodiscard]] size_t size() const {
+        /*
+         * метод получения общего числа пар
+         */
+        size_t total = 0;
+        for (auto &shard: shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.tree.size();
+        }
+        return total;
+    }
+
+    [[nodiscard]] bool empty() const {
+        /*
+         * метод проверки всех шардов на пустоту
+         */
+        return size() == 0;
+    }
+
+    void clear() {
+        /*
+         * метод очищения всех шардов
+         */
+        for (auto &shard: shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.tree.clear();
+        }
+    }
+
+    [[nodiscard]] inline size_t shard_count() const noexcept {
+        /*
+         * метод получения числа шардов
+         */
+        return shards.size();
+    }
+
+private:
+    struct alignas(64) Shard {
+        /*
+         * шард выровнен по кэш-линии, чтобы мьютексы соседних шардов не делили одну линию
+         */
+        mutable std::mutex mutex;
+        SplayTree<K, V, Policy> tree;
+    };
+
+    std::vector<Shard> shards;
+    std::vector<K> bounds;  // пустой вектор - хеш-разбиение
+
+    Shard &_shard(const K &key) noexcept {
+        /*
+         * шард, которому принадлежит ключ
+         */
+        if (!bounds.empty()) {
+            return shards[std::upper_bound(bounds.begin(), bounds.end(), key) - bounds.begin()];
+        }
+        auto hash = static_cast<uint64_t>(std::hash<K>{}(key)) * 0x9E3779B97F4A7C15ull;
+        return shards[(hash >> 32) % shards.size()];
+    }
+};
+
+#endif //SPLAYTREE_SHARDED_SPLAY_TREE_HPP
@@ -0,0 +1,72 @@
+#ifndef SPLAYTREE_SPLAY_NODE_HPP
+#define SPLAYTREE_SPLAY_NODE_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+template<class Node, bool Parent>
+struct SplayParentLink {
+    /*
+     * указатель на родителя - только у узлов политик, которые поднимаются по дереву
+     */
+    Node *parent;
+
+    explicit SplayParentLink(Node *p) noexcept: parent(p) {}
+};
+
+template<class Node>
+struct SplayParentLink<Node, false> {
+    explicit SplayParentLink(Node *) noexcept {}
+};
+
+template<class K, class V, bool Parent>
+struct SplayNode : SplayParentLink<SplayNode<K, V, Parent>, Parent> {
+    /*
+     * структура узла дерева, его поля: левый ребенок, правый ребенок, размер поддерева, ключ и значение,
+     * а при Parent = true еще и родитель (у узла без родителя аргумент p конструкторов не используется)
+     */
+    SplayNode *left;
+    SplayNode *right;
+    size_t size;
+    K key;
+    V value;
+
+    explicit SplayNode(
+            K k = 0,
+            V v = 0,
+            SplayNode *p = nullptr) noexcept: SplayParentLink<SplayNode, Parent>(p), left(nullptr), right(nullptr),
+                                              size(1), key(std::move(k)), value(std::move(v)) {}
+
+    template<class Key, class... Args>
+    SplayNode(std::piecewise_construct_t, Key &&k, SplayNode *p, Args &&... args)
+            : SplayParentLink<SplayNode, Parent>(p), left(nullptr), right(nullptr), size(1),
+              key(std::forward<Key>(k)), value(std::forward<Args>(args)...) {}
+
+    static size_t size_of(const SplayNode *x) noexcept {
+        /*
+         * размер поддерева с корнем x (0 для пустого)
+         */
+        return x ? x->size : 0;
+    }
+
+    void update() noexcept {
+        /*
+         * пересчет размера поддерева по детям
+         */
+        size = 1 + size_of(left) + size_of(right);
+    }
+
+    [[nodiscard]] std::string to_string(const SplayNode *p) const noexcept {
+        /*
+         * метод перевода узла в строку, имеющую формат, заданный в задании
+         */
+        if (p) {
+            return "[" + std::to_string(key) + " " + static_cast<std::string>(value) + " " +
+                   std::to_string(p->key) + "]";
+        }
+        return "[" + std::to_string(key) + " " + static_cast<std::string>(value) + "]";
+    }
+};
+
+#endif //SPLAYTREE_SPLAY_NODE_HPP
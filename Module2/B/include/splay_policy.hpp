@@ -0,0 +1,281 @@
+#ifndef SPLAYTREE_SPLAY_POLICY_HPP
+#define SPLAYTREE_SPLAY_POLICY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ratio>
+
+/*
+ * политика splay задает способ перестройки дерева:
+ *  - splay(x) всегда поднимает x в корень (на этом держатся удаление, split/join, ранги и границы);
+ *  - access(x) вызывается при поиске, изменении значения, добавлении и min/max и может перестраивать дерево
+ *    частично или не перестраивать вовсе;
+ *  - rotations - число выполненных поворотов для подбора политики под нагрузку
+ */
+
+struct BottomUpSplay {
+    /*
+     * классический splay снизу вверх: узел сначала находится спуском, затем поднимается к корню по указателям
+     * на родителя
+     */
+    static constexpr bool parent_links = true;
+
+    size_t rotations = 0;
+
+    template<class Node>
+    Node *splay(Node *x) noexcept {
+        /*
+         * алгоритм splay для узла x
+         * возвращает узел x, который стал корнем (если был определен)
+         */
+        if (!x || !x->parent) {
+            return x;
+        }
+        Node *parent;
+        Node *grandparent;
+        while (x->parent) {
+            parent = x->parent;
+            grandparent = parent->parent;
+            if (!grandparent) {
+                _zig(x);
+            } else if ((x == parent->left && parent == grandparent->left) ||
+                       (x == parent->right && parent == grandparent->right)) {
+                _zig_zig(x);
+            } else {
+                _zig_zag(x);
+            }
+        }
+        return x;
+    }
+
+    template<class Node>
+    void access(Node *x) noexcept {
+        /*
+         * полный splay при каждом обращении
+         */
+        splay(x);
+    }
+
+protected:
+    template<class Node>
+    void _zig(Node *x) noexcept {
+        /*
+         * алгоритм Zig для узла x
+         */
+        ++rotations;
+        auto parent = x->parent;
+        auto grandparent = parent->parent;
+        if (grandparent) {
+            if (grandparent->left == parent) {
+                grandparent->left = x;
+            } else {
+                grandparent->right = x;
+            }
+        }
+        if (parent->left == x) {
+            auto right_tree = x->right;
+            parent->left = right_tree;
+            if (right_tree) {
+                right_tree->parent = parent;
+            }
+            x->right = parent;
+            x->parent = parent->parent;
+            parent->parent = x;
+        } else {
+            auto left_tree = x->left;
+            parent->right = left_tree;
+            if (left_tree) {
+                left_tree->parent = parent;
+            }
+            x->left = parent;
+            x->parent = parent->parent;
+            parent->parent = x;
+        }
+        parent->update();
+        x->update();
+    }
+
+    template<class Node>
+    void _zig_zig(Node *x) noexcept {
+        /*
+         * алгоритм ZigZig для узла x, реализованный через алгоритмы Zig
+         */
+        _zig(x->parent);
+        _zig(x);
+    }
+
+    template<class Node>
+    void _zig_zag(Node *x) noexcept {
+        /*
+         * алгоритм ZigZag для узла x, реализованный через алгоритмы Zig
+         */
+        _zig(x);
+        _zig(x);
+    }
+};
+
+struct SemiSplay : BottomUpSplay {
+    /*
+     * полурасширение (semi-splay): в случае ZigZig поворачивается только родитель, и подъем продолжается уже от
+     * него, поэтому путь к узлу сокращается примерно вдвое за меньшее число поворотов, а сам узел до корня
+     * не доходит
+     */
+    template<class Node>
+    void access(Node *x) noexcept {
+        /*
+         * полурасширение пути от x до корня
+         */
+        Node *parent;
+        Node *grandparent;
+        while (x && x->parent) {
+            parent = x->parent;
+            grandparent = parent->parent;
+            if (!grandparent) {
+                _zig(x);
+                return;
+            }
+            if ((x == parent->left && parent == grandparent->left) ||
+                (x == parent->right && parent == grandparent->right)) {
+                _zig(parent);
+                x = parent;
+            } else {
+                _zig_zag(x);
+            }
+        }
+    }
+};
+
+template<size_t Depth>
+struct DepthThresholdSplay : BottomUpSplay {
+    /*
+     * splay только тех узлов, которые лежат глубже Depth: рабочее множество у корня не перестраивается
+     */
+    template<class Node>
+    void access(Node *x) noexcept {
+        /*
+         * глубина считается не дальше порога
+         */
+        size_t depth = 0;
+        for (auto y = x; y && y->parent && depth <= Depth; y = y->parent) {
+            ++depth;
+        }
+        if (depth > Depth) {
+            splay(x);
+        }
+    }
+};
+
+template<class Probability = std::ratio<1, 2>>
+struct RandomSplay : BottomUpSplay {
+    /*
+     * splay с вероятностью Probability при каждом обращении
+     */
+    static_assert(Probability::num >= 0 && Probability::num <= Probability::den, "Probability must be in [0, 1]");
+
+    std::minstd_rand generator;
+
+    template<class Node>
+    void access(Node *x) noexcept {
+        /*
+         * бросок монетки решает, делать ли полный splay
+         */
+        auto range = static_cast<uint64_t>(std::minstd_rand::max() - std::minstd_rand::min()) + 1;
+        auto roll = static_cast<uint64_t>(generator() - std::minstd_rand::min());
+        if (roll * Probability::den < range * Probability::num) {
+            splay(x);
+        }
+    }
+};
+
+struct TopDownSplay {
+    /*
+     * splay сверху вниз (Слитор-Тарьян): дерево перестраивается за один спуск, узлы пути развешиваются на левое
+     * и правое дерево, поэтому указатель на родителя не нужен
+     */
+    static constexpr bool parent_links = false;
+
+    size_t rotations = 0;
+
+    template<class Node, class Compare>
+    Node *splay(Node *t, Compare direction) noexcept {
+        /*
+         * алгоритм splay сверху вниз в дереве с корнем t
+         * direction(узел) < 0 - искомое левее узла, > 0 - правее, 0 - узел найден
+         * возвращает новый корень: найденный узел или последний узел на пути спуска
+         * размеры поддеревьев левого и правого дерева известны только в конце спуска, поэтому они досчитываются
+         * вторым проходом по узлам пути
+         */
+        if (!t) {
+            return t;
+        }
+        Node *left_tree = nullptr;
+        Node *right_tree = nullptr;
+        Node **left_hook = &left_tree;    // куда подвесить следующий узел левого дерева (его макс. правая связь)
+        Node **right_hook = &right_tree;  // куда подвесить следующий узел правого дерева (его мин. левая связь)
+        size_t left_size = 0;             // число узлов, уже подвешенных в левое дерево
+        size_t right_size = 0;            // число узлов, уже подвешенных в правое дерево
+        for (;;) {
+            auto dir = direction(t);
+            if (dir < 0) {
+                if (!t->left) {
+                    break;
+                }
+                if (direction(t->left) < 0) {
+                    auto child = t->left;
+                    t->left = child->right;
+                    child->right = t;
+                    t->update();
+                    ++rotations;
+                    t = child;
+                    if (!t->left) {
+                        break;
+                    }
+                }
+                right_size += 1 + Node::size_of(t->right);
+                *right_hook = t;
+                right_hook = &t->left;
+                t = t->left;
+            } else if (dir > 0) {
+                if (!t->right) {
+                    break;
+                }
+                if (direction(t->right) > 0) {
+                    auto child = t->right;
+                    t->right = child->left;
+                    child->left = t;
+                    t->update();
+                    ++rotations;
+                    t = child;
+                    if (!t->right) {
+                        break;
+                    }
+                }
+                left_size += 1 + Node::size_of(t->left);
+                *left_hook = t;
+                left_hook = &t->right;
+                t = t->right;
+            } else {
+                break;
+            }
+        }
+        *left_hook = t->left;
+        *right_hook = t->right;
+        left_size += Node::size_of(t->left);
+        right_size += Node::size_of(t->right);
+        for (auto x = left_tree; x != t->left; x = x->right) {
+            x->size = left_size;
+            left_size -= 1 + Node::size_of(x->left);
+        }
+        for (auto x = right_tree; x != t->right; x = x->left) {
+            x->size = right_size;
+            right_size -= 1 + Node::size_of(x->right);
+        }
+        t->left = left_tree;
+        t->right = right_tree;
+        t->update();
+        return t;
+    }
+};
+
+#endif //SPLAYTREE_SPLAY_POLICY_HPP
@@ -1,16 +1,68 @@
 #ifndef SPLAYTREE_SPLAY_TREE_HPP
 #define SPLAYTREE_SPLAY_TREE_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <queue>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
-template<class K = int64_t, class V = std::string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "frozen_tree.hpp"
+#include "node_pool.hpp"
+#include "splay_node.hpp"
+#include "splay_policy.hpp"
+
+template<class K = int64_t, class V = std::string, class Policy = BottomUpSplay>
 class SplayTree {
 public:
-    SplayTree() noexcept: root(nullptr) {}
+    template<bool Const>
+    class Iterator;
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    SplayTree() noexcept: root(nullptr), finger(nullptr) {}
+
+    SplayTree(const SplayTree &) = delete;
+
+    SplayTree(SplayTree &&other) noexcept: root(other.root), finger(other.finger), pool(std::move(other.pool)),
+                                           policy(std::move(other.policy)) {
+        other.root = nullptr;
+        other.finger = nullptr;
+    }
+
+    SplayTree &operator=(const SplayTree &) = delete;
+
+    SplayTree &operator=(SplayTree &&other) noexcept {
+        if (this != &other) {
+            clear();
+            root = other.root;
+            finger = other.finger;
+            pool = std::move(other.pool);
+            policy = std::move(other.policy);
+            other.root = nullptr;
+            other.finger = nullptr;
+        }
+        return *this;
+    }
 
     ~SplayTree() noexcept {
         if (!empty()) {
@@ -18,40 +70,72 @@ public:
         }
     }
 
-    void add(const K &key, const V &value) {
+    template<class InputIt>
+    static SplayTree build(InputIt first, InputIt last) {
         /*
-         * метод добавления узла в дерево, если узла с таким ключом нет
+         * метод построения идеально сбалансированного дерева из диапазона пар (ключ, значение)
+         * отсортированный по возрастанию ключей диапазон с произвольным доступом строится за O(n) без копирования,
+         * остальные сначала копируются и сортируются
+         * если ключи повторяются, вызывает исключение
          */
-        if (empty()) {
-            root = new Node{key, value};
-            return;
+        auto less = [](const auto &a, const auto &b) {
+            return a.first < b.first;
+        };
+        auto not_increasing = [](const auto &a, const auto &b) {
+            return !(a.first < b.first);
+        };
+        SplayTree tree;
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                typename std::iterator_traits<InputIt>::iterator_category>) {
+            if (std::adjacent_find(first, last, not_increasing) == last) {
+                tree._build(first, last);
+                return tree;
+            }
         }
-        auto search_result = _search(root, key);
-        if (search_result.second) {
-            root = _splay(search_result.first);
+        std::vector<std::pair<K, V>> items(first, last);
+        std::sort(items.begin(), items.end(), less);
+        if (std::adjacent_find(items.begin(), items.end(), not_increasing) != items.end()) {
             throw std::logic_error{"Node with this key have already added"};
         }
-        auto new_node = new Node{key, value, search_result.first};
-        if (key < search_result.first->key) {
-            search_result.first->left = new_node;
-        } else {
-            search_result.first->right = new_node;
-        }
-        root = _splay(new_node);
+        tree._build(std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+        return tree;
+    }
+
+    void add(const K &key, const V &value) {
+        /*
+         * метод добавления узла в дерево, если узла с таким ключом нет
+         */
+        _insert(key, value);
+    }
+
+    void add(K &&key, V &&value) {
+        /*
+         * добавление с переносом ключа и значения в узел без копирования
+         */
+        _insert(std::move(key), std::move(value));
+    }
+
+    template<class... Args>
+    V &emplace(K key, Args &&... args) {
+        /*
+         * метод добавления узла, значение которого создается прямо в узле из аргументов args
+         * возвращает ссылку на значение нового узла, если ключ уже есть, вызывает исключение
+         */
+        return _insert(std::move(key), std::forward<Args>(args)...)->value;
     }
 
     void set(const K &key, const V &new_value) {
         /*
          * метод изменения значения узла по ключу (если такой узел есть)
          */
-        auto search_result = _search(root, key);
-        root = _splay(search_result.first);
-        if (!search_result.second) {
-            throw std::logic_error{"Node with this key doesn't exist"};
-        }
-        if (search_result.first) {
-            search_result.first->value = new_value;
-        }
+        _find_existing(key) = new_value;
+    }
+
+    void set(const K &key, V &&new_value) {
+        /*
+         * изменение значения с переносом нового значения в узел
+         */
+        _find_existing(key) = std::move(new_value);
     }
 
     std::pair<bool, V> search(const K &key) noexcept {
@@ -59,42 +143,68 @@ public:
          * метод поиска по заданному ключу
          * возвращает пару (флаг, значение), если узел найден, флаг равен true, значение - значению н. узла, иначе флаг
          * равен false, значение пустое
+         * значение копируется, для чтения без копирования есть find и get
          */
-        auto search_result = _search(root, key);
-        root = _splay(search_result.first);
-        if (search_result.second) {
-            return std::make_pair(true, search_result.first->value);
+        auto value = find(key);
+        if (value) {
+            return std::make_pair(true, *value);
         }
         return std::make_pair(false, V());
     }
 
+    V *find(const K &key) noexcept {
+        /*
+         * метод поиска по ключу без копирования значения (перестройка та же, что у search)
+         * возвращает указатель на значение в узле или nullptr, если ключа нет
+         * указатель действителен до удаления узла: повороты узлы не перемещают
+         */
+        auto search_result = _lookup(key);
+        return search_result.second ? &search_result.first->value : nullptr;
+    }
+
+    std::optional<std::reference_wrapper<V>> get(const K &key) noexcept {
+        /*
+         * то же, что find, в виде необязательной ссылки на значение
+         */
+        auto value = find(key);
+        if (value) {
+            return std::ref(*value);
+        }
+        return std::nullopt;
+    }
+
     void remove(const K &key) {
         /*
          * метод удаления узла с заданным ключом (если такой узел есть в дереве)
          */
-        auto search_result = _search(root, key);
+        auto search_result = _access(key);
         auto node = search_result.first;
-        root = _splay(node);
         if (search_result.second) {
-            if (node->left) {
-                node->left->parent = nullptr;
-            }
-            if (node->right) {
-                node->right->parent = nullptr;
+            if constexpr (parent_links) {
+                if (node->left) {
+                    node->left->parent = nullptr;
+                }
+                if (node->right) {
+                    node->right->parent = nullptr;
+                }
             }
             if (!node->left) {
                 root = node->right;
             } else if (!node->right) {
                 root = node->left;
             } else {
-                node->left = _splay(_max(node->left));
+                node->left = _splay_max(node->left);
                 node->left->right = node->right;
-                if (node->right) {
+                if constexpr (parent_links) {
                     node->right->parent = node->left;
                 }
+                node->left->update();
                 root = node->left;
             }
-            delete node;
+            if (node == finger) {
+                finger = nullptr;
+            }
+            pool->destroy(node);
             return;
         }
         throw std::logic_error{"Node with this key doesn't exist"};
@@ -106,11 +216,8 @@ public:
          * если дерево не пустое, возвращает пару (ключ н. узла, значение н. узла), иначе вызывает исключение
          */
         if (!empty()) {
-            auto min = _min(root);
-            if (min) {
-                root = _splay(min);
-                return std::make_pair(min->key, min->value);
-            }
+            auto min = find_min();
+            return std::make_pair(min.key(), min.value());
         }
         throw std::logic_error{"Can`t find minimum element in empty tree"};
     }
@@ -121,21 +228,457 @@ public:
          * если дерево не пустое, возвращает пару (ключ н. узла, значение н. узла), иначе вызывает исключение
          */
         if (!empty()) {
+            auto max = find_max();
+            return std::make_pair(max.key(), max.value());
+        }
+        throw std::logic_error{"Can`t find maximum element in empty tree"};
+    }
+
+    iterator find_min() noexcept {
+        /*
+         * метод получения узла с минимальным ключом без копирования (перестройка та же, что у min)
+         * возвращает итератор на узел или end() для пустого дерева
+         */
+        if (empty()) {
+            return end();
+        }
+        if constexpr (parent_links) {
+            auto min = _min(root);
+            _restructure(min);
+            return iterator(this, min);
+        } else {
+            root = _splay_min(root);
+            return iterator(this, root);
+        }
+    }
+
+    iterator find_max() noexcept {
+        /*
+         * метод получения узла с максимальным ключом без копирования (перестройка та же, что у max)
+         * возвращает итератор на узел или end() для пустого дерева
+         */
+        if (empty()) {
+            return end();
+        }
+        if constexpr (parent_links) {
             auto max = _max(root);
-            if (max) {
-                root = _splay(max);
-                return std::make_pair(max->key, max->value);
+            _restructure(max);
+            return iterator(this, max);
+        } else {
+            root = _splay_max(root);
+            return iterator(this, root);
+        }
+    }
+
+    size_t rank(const K &key) noexcept {
+        /*
+         * метод получения ранга ключа - числа ключей дерева, меньших заданного
+         */
+        return _rank(key, false);
+    }
+
+    std::pair<K, V> select(size_t k) {
+        /*
+         * метод получения k-го по возрастанию узла (нумерация с 0), rank(select(k).first) == k
+         * если k не меньше размера дерева, вызывает исключение
+         */
+        if (k >= size()) {
+            throw std::out_of_range{"Rank is out of tree"};
+        }
+        auto x = root;
+        for (auto left = Node::size_of(x->left); k != left; left = Node::size_of(x->left)) {
+            if (k < left) {
+                x = x->left;
+            } else {
+                k -= left + 1;
+                x = x->right;
             }
         }
-        throw std::logic_error{"Can`t find maximum element in empty tree"};
+        if constexpr (parent_links) {
+            root = _splay(x);
+        } else {
+            root = _splay(x->key);
+        }
+        return std::make_pair(root->key, root->value);
+    }
+
+    size_t count_range(const K &lo, const K &hi) noexcept {
+        /*
+         * метод подсчета ключей из отрезка [lo, hi]
+         */
+        if (hi < lo) {
+            return 0;
+        }
+        auto less = _rank(lo, false);
+        return _rank(hi, true) - less;
+    }
+
+    SplayTree split(const K &key) {
+        /*
+         * метод разрезания дерева по ключу: узлы с ключами не меньше key переносятся в возвращаемое дерево,
+         * в этом дереве остаются меньшие
+         * деревья продолжают делить один пул узлов
+         */
+        return SplayTree(_cut(key, false), pool);
+    }
+
+    static SplayTree join(SplayTree &&left, SplayTree &&right) {
+        /*
+         * метод склейки двух деревьев, все ключи left должны быть меньше всех ключей right, иначе вызывает исключение
+         * деревья из одного пула (например, полученные через split) склеиваются за одну операцию splay, пул right,
+         * которым больше никто не владеет, вливается в пул left целиком, иначе узлы right переносятся поштучно
+         */
+        if (left.empty()) {
+            return std::move(right);
+        }
+        if (right.empty()) {
+            return std::move(left);
+        }
+        left.root = left._splay_max(left.root);
+        right.root = right._splay_min(right.root);
+        if (!(left.root->key < right.root->key)) {
+            throw std::logic_error{"Trees can be joined only if all keys of left are less than keys of right"};
+        }
+        if (left.pool != right.pool) {
+            if (right.pool.use_count() == 1) {
+                left.pool->merge(*right.pool);
+            } else {
+                right.root = left._relocate(right.root, *right.pool);
+            }
+            right.pool.reset();
+        }
+        left.root = left._link(left.root, right.root);
+        right.root = nullptr;
+        right.finger = nullptr;
+        return std::move(left);
+    }
+
+    size_t erase_range(const K &lo, const K &hi) noexcept {
+        /*
+         * метод удаления всех узлов с ключами из отрезка [lo, hi]
+         * возвращает число удаленных узлов
+         */
+        if (hi < lo || empty()) {
+            return 0;
+        }
+        auto right = _cut(hi, true);
+        auto middle = _cut(lo, false);
+        root = _link(root, right);
+        auto erased = Node::size_of(middle);
+        _clear(middle, true);
+        return erased;
+    }
+
+    SplayTree extract_range(const K &lo, const K &hi) {
+        /*
+         * метод извлечения всех узлов с ключами из отрезка [lo, hi] в отдельное дерево
+         */
+        if (hi < lo || empty()) {
+            return SplayTree();
+        }
+        auto right = _cut(hi, true);
+        auto middle = _cut(lo, false);
+        root = _link(root, right);
+        return SplayTree(middle, pool);
+    }
+
+    iterator lower_bound(const K &key) noexcept {
+        /*
+         * метод поиска первого узла с ключом не меньше key, найденный узел (или его сосед) поднимается в корень
+         * возвращает итератор на узел или end(), если такого узла нет
+         */
+        if (empty()) {
+            return end();
+        }
+        _access(key);
+        return iterator(this, root->key < key ? _next(root) : root);
+    }
+
+    iterator upper_bound(const K &key) noexcept {
+        /*
+         * метод поиска первого узла с ключом больше key, найденный узел (или его сосед) поднимается в корень
+         * возвращает итератор на узел или end(), если такого узла нет
+         */
+        if (empty()) {
+            return end();
+        }
+        _access(key);
+        return iterator(this, key < root->key ? root : _next(root));
+    }
+
+    iterator search_near(const K &key) noexcept {
+        /*
+         * метод поиска от пальца - последнего узла, к которому обращались (search, set, add, min, max и поиски
+         * от пальца): подъем от него идет лишь до поддерева, в границы которого попадает key, затем спуск
+         * для последовательного доступа с шагом d по рангу стоимость амортизированно O(log d)
+         * возвращает итератор на найденный узел или end()
+         */
+        static_assert(parent_links, "Finger search requires parent links");
+        if (empty()) {
+            return end();
+        }
+        auto x = finger ? finger : root;
+        while (x->parent && (x->key < key || key < x->key)) {
+            auto parent = x->parent;
+            if (x->key < key ? (x == parent->left && key < parent->key) : (x == parent->right && parent->key < key)) {
+                break;
+            }
+            x = parent;
+        }
+        auto search_result = _search(x, key);
+        _restructure(search_result.first);
+        return iterator(this, search_result.second ? search_result.first : nullptr);
+    }
+
+    iterator next_after(const_iterator position) noexcept {
+        /*
+         * метод перехода к следующему по порядку узлу, палец переставляется на него без перестройки дерева
+         * возвращает итератор на следующий узел или end()
+         */
+        static_assert(parent_links, "Finger search requires parent links");
+        auto next = position.node ? _next(position.node) : nullptr;
+        if (next) {
+            finger = next;
+        }
+        return iterator(this, next);
+    }
+
+    iterator next_after() noexcept {
+        /*
+         * переход от текущего пальца (если его нет - от узла с мин. ключом)
+         */
+        static_assert(parent_links, "Finger search requires parent links");
+        if (!finger) {
+            finger = _min(root);
+            return iterator(this, finger);
+        }
+        return next_after(const_iterator(this, finger));
+    }
+
+    template<class Callback>
+    size_t scan(const K &lo, const K &hi, Callback callback) {
+        /*
+         * метод обхода по возрастанию всех узлов с ключами из отрезка [lo, hi], для каждого вызывается
+         * callback(ключ, значение)
+         * splay делается только для границы lo, сам обход идет по стеку и дерево не перестраивает
+         * возвращает число посещенных узлов
+         */
+        if (hi < lo || empty()) {
+            return 0;
+        }
+        _access(lo);
+        std::vector<Node *> path;
+        size_t visited = 0;
+        auto x = root;
+        for (;;) {
+            while (x) {
+                if (x->key < lo) {
+                    x = x->right;
+                } else {
+                    path.push_back(x);
+                    x = x->left;
+                }
+            }
+            if (path.empty()) {
+                break;
+            }
+            x = path.back();
+            path.pop_back();
+            if (hi < x->key) {
+                break;
+            }
+            callback(static_cast<const K &>(x->key), x->value);
+            ++visited;
+            x = x->right;
+        }
+        return visited;
+    }
+
+    [[nodiscard]] FrozenTree<K, V> freeze() const {
+        /*
+         * метод создания неизменяемого снимка дерева для параллельного чтения
+         * дерево при этом не перестраивается, последующие изменения дерева на снимок не влияют
+         */
+        return FrozenTree<K, V>(begin(), end());
+    }
+
+    void save(const std::string &path) const {
+        /*
+         * метод сохранения дерева в двоичный файл: заголовок (сигнатура, размер ключа, число пар), ключи
+         * по возрастанию одним массивом и за ними значения, каждое с префиксом длины
+         * числа пишутся в порядке байт машины; ключ должен быть тривиально копируемым, значение - строкой
+         * или тривиально копируемым
+         * если файл не удалось записать, вызывает исключение
+         */
+        static_assert(std::is_trivially_copyable_v<K>, "Keys must be trivially copyable to be saved");
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error{"Can`t open file " + path};
+        }
+        uint64_t header[2] = {sizeof(K), size()};
+        file.write(snapshot_magic, sizeof(snapshot_magic));
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        for (auto it = begin(); it != end(); ++it) {
+            file.write(reinterpret_cast<const char *>(&it.key()), sizeof(K));
+        }
+        for (auto it = begin(); it != end(); ++it) {
+            auto bytes = _bytes(it.value());
+            uint64_t length = bytes.second;
+            file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+            file.write(bytes.first, static_cast<std::streamsize>(bytes.second));
+        }
+        if (!file.flush()) {
+            throw std::runtime_error{"Can`t write file " + path};
+        }
+    }
+
+    void load(const std::string &path) {
+        /*
+         * метод загрузки дерева из файла, записанного save: файл отображается в память, положения значений
+         * находятся одним проходом, и дерево строится идеально сбалансированным за O(n) без поиска мест вставки
+         * старое содержимое заменяется только после успешного чтения; если файл не открылся или поврежден
+         * (в том числе ключи не возрастают строго или после последнего значения есть лишние байты),
+         * вызывает std::runtime_error и дерево не меняется
+         */
+        static_assert(std::is_trivially_copyable_v<K>, "Keys must be trivially copyable to be loaded");
+        struct Mapping {
+            /*
+             * отображение файла в память, снимается при выходе из метода
+             */
+            int descriptor = -1;
+            void *data = MAP_FAILED;
+            size_t length = 0;
+
+            ~Mapping() {
+                if (data != MAP_FAILED) {
+                    munmap(data, length);
+                }
+                if (descriptor >= 0) {
+                    close(descriptor);
+                }
+            }
+        } mapping;
+        mapping.descriptor = open(path.c_str(), O_RDONLY);
+        struct stat info{};
+        if (mapping.descriptor < 0 || fstat(mapping.descriptor, &info) < 0) {
+            throw std::runtime_error{"Can`t open file " + path};
+        }
+        mapping.length = static_cast<size_t>(info.st_size);
+        constexpr size_t header_size = sizeof(snapshot_magic) + 2 * sizeof(uint64_t);
+        if (mapping.length < header_size) {
+            throw std::runtime_error{"File " + path + " is not a tree snapshot"};
+        }
+        mapping.data = mmap(nullptr, mapping.length, PROT_READ, MAP_PRIVATE, mapping.descriptor, 0);
+        if (mapping.data == MAP_FAILED) {
+            throw std::runtime_error{"Can`t map file " + path};
+        }
+        auto data = static_cast<const char *>(mapping.data);
+        uint64_t header[2];
+        std::memcpy(header, data + sizeof(snapshot_magic), sizeof(header));
+        auto count = header[1];
+        if (std::memcmp(data, snapshot_magic, sizeof(snapshot_magic)) || header[0] != sizeof(K) ||
+            count > (mapping.length - header_size) / sizeof(K)) {
+            throw std::runtime_error{"File " + path + " is not a tree snapshot"};
+        }
+        auto keys = data + header_size;
+        auto key = [keys](size_t i) {
+            K k;
+            std::memcpy(&k, keys + i * sizeof(K), sizeof(K));
+            return k;
+        };
+        std::vector<size_t> offsets(count);  // положения префиксов длины значений
+        size_t position = header_size + count * sizeof(K);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t length;
+            if (mapping.length - position < sizeof(length)) {
+                throw std::runtime_error{"File " + path + " is truncated"};
+            }
+            std::memcpy(&length, data + position, sizeof(length));
+            offsets[i] = position;
+            position += sizeof(length);
+            if (length > mapping.length - position) {
+                throw std::runtime_error{"File " + path + " is truncated"};
+            }
+            position += length;
+            if (i && !(key(i - 1) < key(i))) {
+                throw std::runtime_error{"File " + path + " is not a tree snapshot"};
+            }
+        }
+        if (position != mapping.length) {
+            throw std::runtime_error{"File " + path + " is not a tree snapshot"};
+        }
+        SplayTree tree;
+        tree._build(count, [&key, &offsets, data](size_t i) {
+            uint64_t length;
+            std::memcpy(&length, data + offsets[i], sizeof(length));
+            return std::make_pair(key(i), _value(data + offsets[i] + sizeof(length), length));
+        });
+        *this = std::move(tree);
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, _min(root));
+    }
+
+    iterator end() noexcept {
+        return iterator(this, nullptr);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, _min(root));
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, nullptr);
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    [[nodiscard]] inline size_t rotations() const noexcept {
+        /*
+         * метод получения числа поворотов, выполненных политикой splay за время жизни дерева
+         */
+        return policy.rotations;
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        /*
+         * метод получения числа узлов дерева
+         */
+        return Node::size_of(root);
     }
 
     void clear() noexcept {
         /*
          * метод очищения дерева
+         * узлы живут в слабах пула, поэтому память освобождается слабами целиком, а обход узлов нужен только для
+         * вызова нетривиальных деструкторов ключа и значения
+         * если пул разделен с другими деревьями (после split), узлы возвращаются в него поштучно
          */
-        _clear(root);
+        if (pool.use_count() > 1) {
+            _clear(root, true);
+        } else if (pool) {
+            if constexpr (!std::is_trivially_destructible_v<Node>) {
+                _clear(root, false);
+            }
+            pool->release();
+        }
         root = nullptr;
+        finger = nullptr;
     }
 
     [[nodiscard]] inline bool empty() const noexcept {
@@ -145,130 +688,387 @@ public:
         return root == nullptr;
     }
 
-    template<class Key, class Value>
-    friend std::ostream &operator<<(std::ostream &, const SplayTree<Key, Value> &) noexcept;
+    template<class Key, class Value, class P>
+    friend std::ostream &operator<<(std::ostream &, const SplayTree<Key, Value, P> &) noexcept;
 
 private:
     /*
      * приватные методы реализованы как для обычного БДП, так как не всегда при их вызове нужно делать splay
+     * сам splay выполняет политика: снизу вверх по указателям на родителя или сверху вниз за один спуск
      */
-    struct Node {
+    static constexpr bool parent_links = Policy::parent_links;
+
+    using Node = SplayNode<K, V, parent_links>;
+
+    using Pool = NodePool<Node>;
+
+    static constexpr char snapshot_magic[8] = {'S', 'P', 'L', 'A', 'Y', 'T', 'R', '1'};
+
+    Node *root;
+    Node *finger;  // последний узел, к которому обращались (для поиска от пальца)
+    std::shared_ptr<Pool> pool;
+    Policy policy;
+
+    SplayTree(Node *top, std::shared_ptr<Pool> nodes) noexcept: root(top), finger(nullptr), pool(std::move(nodes)) {}
+
+    Pool &_pool() {
         /*
-         * структура узла дерева, его поля: левый ребенок, правый ребенок, родитель, ключ и значение
+         * пул узлов создается при первом добавлении, чтобы пустые и перемещенные деревья ничего не выделяли
          */
-        Node *left;
-        Node *right;
-        Node *parent;
-        K key;
-        V value;
+        if (!pool) {
+            pool = std::make_shared<Pool>();
+        }
+        return *pool;
+    }
 
-        explicit Node(
-                K k = 0,
-                V v = 0,
-                Node *p = nullptr) noexcept: left(nullptr), right(nullptr), parent(p), key(std::move(k)),
-                                             value(std::move(v)) {}
+    static std::pair<const char *, size_t> _bytes(const V &value) noexcept {
+        /*
+         * байты значения для записи в файл
+         */
+        if constexpr (std::is_trivially_copyable_v<V>) {
+            return std::make_pair(reinterpret_cast<const char *>(&value), sizeof(V));
+        } else {
+            return std::make_pair(value.data(), value.size() * sizeof(*value.data()));
+        }
+    }
 
-        [[nodiscard]] std::string to_string() const noexcept {
-            /*
-             * метод перевода узла в строку, имеющую формат, заданный в задании
-             */
-            if (parent) {
-                return "[" + std::to_string(key) + " " + static_cast<std::string>(value) + " " +
-                       std::to_string(parent->key) + "]";
+    static V _value(const char *bytes, size_t length) {
+        /*
+         * значение из байтов файла
+         */
+        if constexpr (std::is_trivially_copyable_v<V>) {
+            if (length != sizeof(V)) {
+                throw std::runtime_error{"Size of value in snapshot doesn't match"};
+            }
+            V value;
+            std::memcpy(&value, bytes, sizeof(V));
+            return value;
+        } else {
+            using Char = std::remove_const_t<std::remove_pointer_t<decltype(std::declval<const V &>().data())>>;
+            if (length % sizeof(Char)) {
+                throw std::runtime_error{"Size of value in snapshot doesn't match"};
             }
-            return "[" + std::to_string(key) + " " + static_cast<std::string>(value) + "]";
+            V value(length / sizeof(Char), Char());
+            std::memcpy(&value[0], bytes, length);
+            return value;
         }
-    };
+    }
 
-    Node *root;
+    template<class It>
+    void _build(It first, It last) {
+        /*
+         * построение дерева из отсортированного диапазона с произвольным доступом в пустом дереве
+         */
+        _build(static_cast<size_t>(std::distance(first, last)), [first](size_t i) -> decltype(auto) {
+            return first[i];
+        });
+    }
+
+    template<class Item>
+    void _build(size_t count, const Item &item) {
+        /*
+         * построение дерева из count пар, i-я по возрастанию пара - item(i)
+         * все узлы выделяются одним слабом подряд
+         */
+        _pool().reserve(count);
+        root = _build(0, count, nullptr, item);
+    }
+
+    template<class Item>
+    Node *_build(size_t first, size_t last, Node *parent, const Item &item) {
+        /*
+         * построение поддерева из пар с номерами [first, last): средняя пара становится корнем
+         * глубина рекурсии - O(log n)
+         */
+        if (first == last) {
+            return nullptr;
+        }
+        auto middle = first + (last - first) / 2;
+        auto &&pair = item(middle);
+        auto node = pool->create(std::forward<decltype(pair)>(pair).first, std::forward<decltype(pair)>(pair).second,
+                                 parent);
+        node->left = _build(first, middle, node, item);
+        node->right = _build(middle + 1, last, node, item);
+        node->update();
+        return node;
+    }
+
+    Node *_cut(const K &key, bool inclusive) noexcept {
+        /*
+         * отрезание от дерева узлов с ключами не меньше key (больше key, если inclusive)
+         * возвращает корень отрезанного дерева, остальные узлы остаются в root
+         */
+        if (empty()) {
+            return nullptr;
+        }
+        _access(key);
+        finger = nullptr;
+        Node *cut;
+        if (root->key < key || (inclusive && !(key < root->key))) {
+            cut = root->right;
+            root->right = nullptr;
+        } else {
+            cut = root;
+            root = root->left;
+            cut->left = nullptr;
+        }
+        if constexpr (parent_links) {
+            if (cut) {
+                cut->parent = nullptr;
+            }
+            if (root) {
+                root->parent = nullptr;
+            }
+        }
+        if (root) {
+            root->update();
+        }
+        if (cut) {
+            cut->update();
+        }
+        return cut;
+    }
+
+    Node *_link(Node *left, Node *right) noexcept {
+        /*
+         * склейка двух деревьев, все ключи left меньше всех ключей right
+         * возвращает корень объединенного дерева
+         */
+        if (!left) {
+            return right;
+        }
+        left = _splay_max(left);
+        left->right = right;
+        if constexpr (parent_links) {
+            if (right) {
+                right->parent = left;
+            }
+        }
+        left->update();
+        return left;
+    }
 
-    static void _zig(Node *x) noexcept {
+    Node *_relocate(Node *top, Pool &from) {
         /*
-         * алгоритм Zig для узла x
+         * перенос дерева с корнем top из пула from в пул этого дерева с сохранением формы
+         * возвращает корень копии
          */
-        auto parent = x->parent;
-        auto grandparent = parent->parent;
-        if (grandparent) {
-            if (grandparent->left == parent) {
-                grandparent->left = x;
+        auto &to = _pool();
+        std::vector<std::tuple<Node *, Node *, bool>> stack{{top, nullptr, false}};  // узел, родитель копии, слева ли
+        Node *copy_root = nullptr;
+        while (!stack.empty()) {
+            auto [node, parent, is_left] = stack.back();
+            stack.pop_back();
+            auto copy = to.create(std::move(node->key), std::move(node->value));
+            copy->size = node->size;
+            if (!parent) {
+                copy_root = copy;
             } else {
-                grandparent->right = x;
+                (is_left ? parent->left : parent->right) = copy;
+                if constexpr (parent_links) {
+                    copy->parent = parent;
+                }
             }
+            if (node->left) {
+                stack.emplace_back(node->left, copy, true);
+            }
+            if (node->right) {
+                stack.emplace_back(node->right, copy, false);
+            }
+            from.destroy(node);
+        }
+        return copy_root;
+    }
+
+    std::pair<Node *, bool> _access(const K &key) noexcept {
+        /*
+         * поиск узла с указанным ключом и его подъем в корень
+         * возвращает пару (корень, флаг) - флаг равен true, если ключ найден
+         */
+        if constexpr (parent_links) {
+            auto search_result = _search(root, key);
+            root = _splay(search_result.first);
+            return search_result;
+        } else {
+            root = _splay(key);
+            return std::make_pair(root, root && !(key < root->key) && !(root->key < key));
+        }
+    }
+
+    size_t _rank(const K &key, bool inclusive) noexcept {
+        /*
+         * число ключей, меньших key (или не больших, если inclusive)
+         * после splay в корне оказывается key либо его сосед по порядку, поэтому ответ читается из корня
+         */
+        if (empty()) {
+            return 0;
+        }
+        _access(key);
+        if (root->key < key || (inclusive && !(key < root->key))) {
+            return Node::size_of(root->left) + 1;
         }
-        if (parent->left == x) {
-            auto right_tree = x->right;
-            parent->left = right_tree;
-            if (right_tree) {
-                right_tree->parent = parent;
+        return Node::size_of(root->left);
+    }
+
+    template<class Key, class... Args>
+    Node *_insert(Key &&key, Args &&... args) {
+        /*
+         * добавление узла с ключом key, значение создается в узле из args
+         * если узел с таким ключом уже есть, вызывает исключение
+         * возвращает новый узел
+         */
+        if constexpr (parent_links) {
+            if (empty()) {
+                root = _pool().create(std::piecewise_construct, std::forward<Key>(key), nullptr,
+                                      std::forward<Args>(args)...);
+                return root;
+            }
+            auto search_result = _search(root, key);
+            if (search_result.second) {
+                _restructure(search_result.first);
+                throw std::logic_error{"Node with this key have already added"};
             }
-            x->right = parent;
-            x->parent = parent->parent;
-            parent->parent = x;
+            auto parent = search_result.first;
+            auto new_node = pool->create(std::piecewise_construct, std::forward<Key>(key), parent,
+                                         std::forward<Args>(args)...);
+            if (new_node->key < parent->key) {
+                parent->left = new_node;
+            } else {
+                parent->right = new_node;
+            }
+            for (auto x = parent; x; x = x->parent) {
+                ++x->size;
+            }
+            _restructure(new_node);
+            return new_node;
         } else {
-            auto left_tree = x->left;
-            parent->right = left_tree;
-            if (left_tree) {
-                left_tree->parent = parent;
+            if (empty()) {
+                root = _pool().create(std::piecewise_construct, std::forward<Key>(key), nullptr,
+                                      std::forward<Args>(args)...);
+                return root;
+            }
+            root = _splay(key);
+            if (!(key < root->key) && !(root->key < key)) {
+                throw std::logic_error{"Node with this key have already added"};
             }
-            x->left = parent;
-            x->parent = parent->parent;
-            parent->parent = x;
+            auto new_node = pool->create(std::piecewise_construct, std::forward<Key>(key), nullptr,
+                                         std::forward<Args>(args)...);
+            if (new_node->key < root->key) {
+                new_node->left = root->left;
+                new_node->right = root;
+                root->left = nullptr;
+            } else {
+                new_node->right = root->right;
+                new_node->left = root;
+                root->right = nullptr;
+            }
+            root->update();
+            new_node->update();
+            root = new_node;
+            return new_node;
         }
     }
 
-    static void _zig_zig(Node *x) noexcept {
+    V &_find_existing(const K &key) {
         /*
-         * алгоритм ZigZig для узла x, реализованный через алгоритмы Zig
+         * значение узла с ключом key для изменения, если узла нет, вызывает исключение
          */
-        _zig(x->parent);
-        _zig(x);
+        auto value = find(key);
+        if (!value) {
+            throw std::logic_error{"Node with this key doesn't exist"};
+        }
+        return *value;
     }
 
-    static void _zig_zag(Node *x) noexcept {
+    std::pair<Node *, bool> _lookup(const K &key) noexcept {
         /*
-         * алгоритм ZigZag для узла x, реализованный через алгоритмы Zig
+         * поиск узла с указанным ключом для чтения или изменения значения
+         * перестройку выбирает политика, поэтому найденный узел может не оказаться в корне
          */
-        _zig(x);
-        _zig(x);
+        if constexpr (parent_links) {
+            auto search_result = _search(root, key);
+            _restructure(search_result.first);
+            return search_result;
+        } else {
+            return _access(key);
+        }
     }
 
-    static Node *_splay(Node *x) noexcept {
+    void _restructure(Node *x) noexcept {
         /*
-         * алгоритм splay для узла x
-         * возвращает узел x, который стал корнем (если был определен)
+         * перестройка дерева после обращения к узлу x по правилу политики
+         * старый корень при поворотах опускается не больше чем на пару уровней, поэтому новый корень находится
+         * подъемом от него
          */
-        if (!x || !x->parent) {
-            return x;
-        }
-        Node *parent;
-        Node *grandparent;
-        while (x->parent) {
-            parent = x->parent;
-            grandparent = parent->parent;
-            if (!grandparent) {
-                _zig(x);
-            } else if ((x == parent->left && parent == grandparent->left) ||
-                       (x == parent->right && parent == grandparent->right)) {
-                _zig_zig(x);
-            } else {
-                _zig_zag(x);
+        if (x) {
+            policy.access(x);
+            while (root->parent) {
+                root = root->parent;
             }
+            finger = x;
         }
-        return x;
     }
 
-    static void _clear(Node *p) noexcept {
+    Node *_splay(Node *x) noexcept {
         /*
-         * удаление дерева
+         * splay для узла x (только для политик с указателем на родителя)
          */
-        if (p) {
+        return policy.splay(x);
+    }
+
+    Node *_splay(const K &key) noexcept {
+        /*
+         * splay сверху вниз по ключу в дереве с корнем root
+         */
+        return policy.splay(root, [&key](const Node *x) {
+            return key < x->key ? -1 : (x->key < key ? 1 : 0);
+        });
+    }
+
+    Node *_splay_min(Node *top) noexcept {
+        /*
+         * подъем узла с мин. ключом в корень поддерева top
+         */
+        if constexpr (parent_links) {
+            return _splay(_min(top));
+        } else {
+            return policy.splay(top, [](const Node *) { return -1; });
+        }
+    }
+
+    Node *_splay_max(Node *top) noexcept {
+        /*
+         * подъем узла с макс. ключом в корень поддерева top
+         */
+        if constexpr (parent_links) {
+            return _splay(_max(top));
+        } else {
+            return policy.splay(top, [](const Node *) { return 1; });
+        }
+    }
+
+    void _clear(Node *p, bool deallocate) noexcept {
+        /*
+         * удаление всех узлов дерева с корнем p: либо с возвратом в пул, либо только вызов деструкторов (если пул
+         * затем освобождается целиком)
+         * обход без рекурсии и доп. памяти: левое поддерево поворотами переносится направо, поэтому глубина
+         * вырожденного дерева не влияет на стек
+         */
+        while (p) {
             if (p->left) {
-                _clear(p->left);
-            }
-            if (p->right) {
-                _clear(p->right);
+                auto left = p->left;
+                p->left = left->right;
+                left->right = p;
+                p = left;
+            } else {
+                auto right = p->right;
+                if (deallocate) {
+                    pool->destroy(p);
+                } else {
+                    p->~Node();
+                }
+                p = right;
             }
-            delete p;
         }
     }
 
@@ -297,6 +1097,62 @@ private:
         return std::make_pair(top, true);
     }
 
+    Node *_next(const Node *x) const noexcept {
+        /*
+         * следующий по порядку узел без перестройки дерева
+         * с указателем на родителя - подъем по дереву, иначе - спуск от корня по ключу
+         */
+        if constexpr (parent_links) {
+            if (x->right) {
+                return _min(x->right);
+            }
+            while (x->parent && x->parent->right == x) {
+                x = x->parent;
+            }
+            return x->parent;
+        } else {
+            Node *next = nullptr;
+            for (auto y = root; y;) {
+                if (x->key < y->key) {
+                    next = y;
+                    y = y->left;
+                } else {
+                    y = y->right;
+                }
+            }
+            return next;
+        }
+    }
+
+    Node *_prev(const Node *x) const noexcept {
+        /*
+         * предыдущий по порядку узел без перестройки дерева, для end() - узел с макс. ключом
+         */
+        if (!x) {
+            return _max(root);
+        }
+        if constexpr (parent_links) {
+            if (x->left) {
+                return _max(x->left);
+            }
+            while (x->parent && x->parent->left == x) {
+                x = x->parent;
+            }
+            return x->parent;
+        } else {
+            Node *prev = nullptr;
+            for (auto y = root; y;) {
+                if (y->key < x->key) {
+                    prev = y;
+                    y = y->right;
+                } else {
+                    y = y->left;
+                }
+            }
+            return prev;
+        }
+    }
+
     static Node *_min(Node *x) {
         /*
          * поиск узла с мин. ключом в дереве с корнем x
@@ -326,19 +1182,98 @@ private:
     }
 };
 
-template<class Key, class Value>
-std::ostream &operator<<(std::ostream &out, const SplayTree<Key, Value> &tree) noexcept {
+template<class K, class V, class Policy>
+template<bool Const>
+class SplayTree<K, V, Policy>::Iterator {
+    /*
+     * двунаправленный итератор по возрастанию ключей, разыменование дает пару ссылок (ключ, значение)
+     * обход дерево не перестраивает, итератор остается валидным после splay и инвалидируется только удалением узла
+     */
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<const K, V>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const K &, std::conditional_t<Const, const V &, V &>>;
+    using pointer = void;
+
+    Iterator() noexcept: tree(nullptr), node(nullptr) {}
+
+    operator Iterator<true>() const noexcept {
+        return Iterator<true>(tree, node);
+    }
+
+    reference operator*() const noexcept {
+        return reference(node->key, node->value);
+    }
+
+    const K &key() const noexcept {
+        return node->key;
+    }
+
+    std::conditional_t<Const, const V &, V &> value() const noexcept {
+        return node->value;
+    }
+
+    Iterator &operator++() noexcept {
+        node = tree->_next(node);
+        return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    Iterator &operator--() noexcept {
+        node = tree->_prev(node);
+        return *this;
+    }
+
+    Iterator operator--(int) noexcept {
+        auto copy = *this;
+        --*this;
+        return copy;
+    }
+
+    bool operator==(const Iterator &other) const noexcept {
+        return node == other.node;
+    }
+
+    bool operator!=(const Iterator &other) const noexcept {
+        return node != other.node;
+    }
+
+private:
+    friend class SplayTree;
+    friend class Iterator<!Const>;
+
+    const SplayTree *tree;
+    Node *node;
+
+    Iterator(const SplayTree *t, Node *n) noexcept: tree(t), node(n) {}
+};
+
+template<class Key, class Value, class P>
+std::ostream &operator<<(std::ostream &out, const SplayTree<Key, Value, P> &tree) noexcept {
     if (tree.empty()) {
         out << "_\n";
         return out;
     }
 
-    using Node = typename SplayTree<Key, Value>::Node *;
-    using node_info = std::pair<Node, size_t>;
+    using Node = const typename SplayTree<Key, Value, P>::Node *;
+    struct node_info {
+        /*
+         * узел слоя, его родитель (узел может не хранить указатель на него) и число подряд идущих пустых позиций
+         */
+        Node node;
+        Node parent;
+        size_t count;
+    };
 
     std::queue<node_info> curr_layer;
     std::queue<node_info> next_layer;
-    curr_layer.push(std::make_pair(tree.root, int(tree.root == nullptr)));
+    curr_layer.push({tree.root, nullptr, 0});
 
     node_info node;
     size_t layer_size;
@@ -351,36 +1286,36 @@ std::ostream &operator<<(std::ostream &out, const SplayTree<Key, Value> &tree) n
             }
             node = curr_layer.front();
             curr_layer.pop();
-            if (node.first) {
-                out << node.first->to_string();
+            if (node.node) {
+                out << node.node->to_string(node.parent);
 
-                if (node.first->left) {
-                    next_layer.push(std::make_pair(node.first->left, 0));
-                } else if (next_layer.empty() || next_layer.back().first) {
-                    next_layer.push(std::make_pair(nullptr, 1));
+                if (node.node->left) {
+                    next_layer.push({node.node->left, node.node, 0});
+                } else if (next_layer.empty() || next_layer.back().node) {
+                    next_layer.push({nullptr, nullptr, 1});
                 } else {
-                    ++next_layer.back().second;
+                    ++next_layer.back().count;
                 }
 
-                if (node.first->right) {
-                    next_layer.push(std::make_pair(node.first->right, 0));
-                } else if (next_layer.empty() || next_layer.back().first) {
-                    next_layer.push(std::make_pair(nullptr, 1));
+                if (node.node->right) {
+                    next_layer.push({node.node->right, node.node, 0});
+                } else if (next_layer.empty() || next_layer.back().node) {
+                    next_layer.push({nullptr, nullptr, 1});
                 } else {
-                    ++next_layer.back().second;
+                    ++next_layer.back().count;
                 }
             } else {
-                temp.reserve(2 * node.second - 2);
-                for (size_t j = node.second - 1; j; --j) {
+                temp.reserve(2 * node.count - 2);
+                for (size_t j = node.count - 1; j; --j) {
                     temp.append(" _", 2);
                 }
                 out << '_' << temp;
                 temp.clear();
-                if (next_layer.empty() || next_layer.back().first) {
-                    next_layer.push(std::make_pair(nullptr, 1));
-                    next_layer.back().second = node.second * 2;
+                if (next_layer.empty() || next_layer.back().node) {
+                    next_layer.push({nullptr, nullptr, 1});
+                    next_layer.back().count = node.count * 2;
                 } else {
-                    next_layer.back().second += node.second * 2;
+                    next_layer.back().count += node.count * 2;
                 }
             }
         }
@@ -403,17 +1338,18 @@ void parser(const std::string &&command, std::string &name, std::string &key, st
     std::istringstream stream(command);
     stream >> name >> key >> value >> dump;
 }
-template<class O, class I>
-void handler(O &stream_out, I &stream_in) {
-    SplayTree<int64_t, std::string> spt;
 
+template<class Tree, class O, class I>
+void run_commands(Tree &spt, O &stream_out, I &stream_in) {
+    /*
+     * функция выполнения команд из stream_in над словарем spt с интерфейсом SplayTree (например, BTree)
+     */
     std::string command;
     std::string name;
     std::basic_string<char> key;
     std::string value;
     std::string dump;
 
-    std::pair<bool, std::string> search_res;
     std::pair<int64_t, std::string> minmax_res;
 
     while (getline(stream_in, command)) {
@@ -423,19 +1359,19 @@ void handler(O &stream_out, I &stream_in) {
         parser(std::move(command), name, key, value, dump);
         if (key.empty()) {
             if (name == "min") {
-                try {
-                    minmax_res = spt.min();
-                    stream_out << minmax_res.first << ' ' << minmax_res.second << '\n';
-                } catch (std::logic_error &) {
+                auto min_it = spt.find_min();
+                if (min_it == spt.end()) {
                     stream_out << "error\n";
+                    continue;
                 }
+                stream_out << min_it.key() << ' ' << min_it.value() << '\n';
             } else if (name == "max") {
-                try {
-                    minmax_res = spt.max();
-                    stream_out << minmax_res.first << ' ' << minmax_res.second << '\n';
-                } catch (std::logic_error &) {
+                auto max_it = spt.find_max();
+                if (max_it == spt.end()) {
                     stream_out << "error\n";
+                    continue;
                 }
+                stream_out << max_it.key() << ' ' << max_it.value() << '\n';
             } else if (name == "print") {
                 stream_out << spt;
             } else {
@@ -447,9 +1383,9 @@ void handler(O &stream_out, I &stream_in) {
                     stream_out << "error\n";
                     continue;
                 }
-                search_res = spt.search(std::stoll(key));
-                if (search_res.first) {
-                    stream_out << "1 " << search_res.second << '\n';
+                auto found = spt.find(std::stoll(key));
+                if (found) {
+                    stream_out << "1 " << *found << '\n';
                     continue;
                 }
                 stream_out << "0\n";
@@ -463,15 +1399,38 @@ void handler(O &stream_out, I &stream_in) {
                 } catch (std::logic_error &) {
                     stream_out << "error\n";
                 }
+            } else if (name == "rank") {
+                if (!value.empty()) {
+                    stream_out << "error\n";
+                    continue;
+                }
+                stream_out << spt.rank(std::stoll(key)) << '\n';
+            } else if (name == "select") {
+                if (!value.empty() || key.front() == '-') {
+                    stream_out << "error\n";
+                    continue;
+                }
+                try {
+                    minmax_res = spt.select(std::stoull(key));
+                    stream_out << minmax_res.first << ' ' << minmax_res.second << '\n';
+                } catch (std::out_of_range &) {
+                    stream_out << "error\n";
+                }
+            } else if (name == "count") {
+                if (value.empty()) {
+                    stream_out << "error\n";
+                    continue;
+                }
+                stream_out << spt.count_range(std::stoll(key), std::stoll(value)) << '\n';
             } else if (name == "add") {
                 try {
-                    spt.add(std::stoll(key), value);
+                    spt.add(std::stoll(key), std::move(value));
                 } catch (std::logic_error &) {
                     stream_out << "error\n";
                 }
             } else if (name == "set") {
                 try {
-                    spt.set(std::stoll(key), value);
+                    spt.set(std::stoll(key), std::move(value));
                 } catch (std::logic_error &) {
                     stream_out << "error\n";
                 }
@@ -484,5 +1443,13 @@ void handler(O &stream_out, I &stream_in) {
     }
 }
 
+template<class O, class I>
+void handler(O &stream_out, I &stream_in) {
+    /*
+     * функция обработки команд над SplayTree
+     */
+    SplayTree<int64_t, std::string> spt;
+    run_commands(spt, stream_out, stream_in);
+}
 
 #endif //SPLAYTREE_SPLAY_TREE_HPP
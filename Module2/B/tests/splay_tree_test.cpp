@@ -1,7 +1,13 @@
 #include <fstream>
+#include <list>
+#include <map>
+#include <random>
+#include <thread>
 
 #include <gtest/gtest.h>
 
+#include "btree.hpp"
+#include "sharded_splay_tree.hpp"
 #include "splay_tree.hpp"
 
 TEST(SplayTree_Test, Constructor) {
@@ -158,6 +164,851 @@ TEST(SplayTree_Test, Min_max) {
     EXPECT_EQ(spt.max(), std::make_pair(static_cast<int64_t>(2646), std::string("")));
 }
 
+TEST(SplayTree_Test, Pool) {
+    NodePool<std::pair<int64_t, std::string>> pool;
+    auto first = pool.create(1, "a");
+    auto second = pool.create(2, "b");
+    EXPECT_EQ(first->second, "a");
+    EXPECT_EQ(second->second, "b");
+
+    pool.destroy(first);
+    auto third = pool.create(3, "c");
+    EXPECT_EQ(third, first);
+    EXPECT_EQ(third->second, "c");
+    pool.destroy(second);
+    pool.destroy(third);
+
+    // после reserve создания идут подряд, минуя список свободных
+    std::vector<std::pair<int64_t, std::string> *> run;
+    pool.reserve(3);
+    for (int64_t i = 0; i < 3; ++i) {
+        run.push_back(pool.create(i, ""));
+        EXPECT_NE(run.back(), first);
+        EXPECT_NE(run.back(), second);
+    }
+    EXPECT_EQ(run[1], run[0] + 1);
+    EXPECT_EQ(run[2], run[1] + 1);
+    auto reused = pool.create(4, "d");
+    EXPECT_TRUE(reused == first || reused == second);
+    for (auto object: run) {
+        pool.destroy(object);
+    }
+    pool.reserve(100);
+    run.assign({reused, pool.create(5, "e"), pool.create(6, "f")});
+    EXPECT_EQ(run[2], run[1] + 1);
+    for (auto object: run) {
+        pool.destroy(object);
+    }
+
+    SplayTree<> spt;
+    for (int64_t i = 0; i < 1000000; ++i) {
+        spt.add(i, "");
+    }
+    spt.remove(500000);
+    spt.add(500000, "reused");
+    EXPECT_EQ(spt.search(500000), std::make_pair(true, std::string("reused")));
+    spt.search(0);
+    spt.clear();
+    EXPECT_TRUE(spt.empty());
+    spt.add(1, "a");
+    EXPECT_EQ(spt.min(), std::make_pair(static_cast<int64_t>(1), std::string("a")));
+}
+
+TEST(SplayTree_Test, Top_down) {
+    SplayTree<int64_t, std::string, TopDownSplay> spt;
+    std::stringstream out;
+    out << spt;
+    spt.add(1, "a");
+    spt.add(2, "b");
+    spt.add(3, "c");
+    out << spt;
+    EXPECT_EQ(out.str(), "_\n[3 c]\n[2 b 3] _\n[1 a 2] _ _ _\n");
+    EXPECT_THROW(spt.add(2, "bb"), std::logic_error);
+    EXPECT_THROW(spt.set(4, "d"), std::logic_error);
+    EXPECT_THROW(spt.remove(4), std::logic_error);
+
+    std::map<int64_t, std::string> expected{{1, "a"}, {2, "b"}, {3, "c"}};
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int64_t> keys(-500, 500);
+    for (size_t i = 0; i < 20000; ++i) {
+        auto key = keys(gen);
+        auto value = std::to_string(i);
+        switch (gen() % 4) {
+            case 0:
+                if (expected.emplace(key, value).second) {
+                    spt.add(key, value);
+                } else {
+                    EXPECT_THROW(spt.add(key, value), std::logic_error);
+                }
+                break;
+            case 1:
+                if (expected.erase(key)) {
+                    spt.remove(key);
+                } else {
+                    EXPECT_THROW(spt.remove(key), std::logic_error);
+                }
+                break;
+            case 2:
+                if (expected.count(key)) {
+                    expected[key] = value;
+                    spt.set(key, value);
+                }
+                break;
+            default:
+                EXPECT_EQ(spt.search(key).first, expected.count(key) == 1);
+        }
+        if (!expected.empty() && i % 100 == 0) {
+            EXPECT_EQ(spt.min().first, expected.begin()->first);
+            EXPECT_EQ(spt.max().first, expected.rbegin()->first);
+        }
+    }
+    for (auto &item: expected) {
+        EXPECT_EQ(spt.search(item.first), std::make_pair(true, item.second));
+    }
+}
+
+template<class Policy>
+void check_order_statistics() {
+    SplayTree<int64_t, std::string, Policy> spt;
+    EXPECT_EQ(spt.rank(5), 0);
+    EXPECT_EQ(spt.count_range(0, 10), 0);
+    EXPECT_THROW(spt.select(0), std::out_of_range);
+
+    std::map<int64_t, std::string> expected;
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int64_t> keys(-1000, 1000);
+    for (size_t i = 0; i < 5000; ++i) {
+        auto key = keys(gen);
+        if (gen() % 3) {
+            if (expected.emplace(key, std::to_string(key)).second) {
+                spt.add(key, std::to_string(key));
+            }
+        } else if (expected.erase(key)) {
+            spt.remove(key);
+        }
+        auto probe = keys(gen);
+        ASSERT_EQ(spt.size(), expected.size());
+        EXPECT_EQ(spt.rank(probe), std::distance(expected.begin(), expected.lower_bound(probe)));
+        if (!expected.empty()) {
+            auto k = gen() % expected.size();
+            auto kth = std::next(expected.begin(), static_cast<int64_t>(k));
+            EXPECT_EQ(spt.select(k), std::make_pair(kth->first, kth->second));
+            EXPECT_EQ(spt.rank(kth->first), k);
+        }
+        auto hi = probe + static_cast<int64_t>(gen() % 200);
+        EXPECT_EQ(spt.count_range(probe, hi),
+                  std::distance(expected.lower_bound(probe), expected.upper_bound(hi)));
+        EXPECT_EQ(spt.count_range(hi, probe - 1), 0);
+    }
+    EXPECT_THROW(spt.select(expected.size()), std::out_of_range);
+}
+
+TEST(SplayTree_Test, Order_statistics) {
+    check_order_statistics<BottomUpSplay>();
+    check_order_statistics<TopDownSplay>();
+
+    std::stringstream in("add 10 a\nadd 20 b\nadd 30 c\nrank 25\nselect 0\nselect 3\nselect -1\n"
+                         "count 10 20\ncount 30 10\ncount 5\n");
+    std::stringstream out;
+    handler<std::stringstream, std::stringstream>(out, in);
+    EXPECT_EQ(out.str(), "2\n10 a\nerror\nerror\n2\n0\nerror\n");
+}
+
+template<class Policy>
+void check_split_join() {
+    using Tree = SplayTree<int64_t, std::string, Policy>;
+    Tree spt;
+    for (int64_t i = 0; i < 100; ++i) {
+        spt.add(i, std::to_string(i));
+    }
+    auto right = spt.split(40);
+    EXPECT_EQ(spt.size(), 40);
+    EXPECT_EQ(right.size(), 60);
+    EXPECT_EQ(spt.max().first, 39);
+    EXPECT_EQ(right.min().first, 40);
+    EXPECT_THROW(Tree::join(std::move(right), std::move(spt)), std::logic_error);
+
+    auto joined = Tree::join(std::move(spt), std::move(right));
+    EXPECT_TRUE(spt.empty());
+    EXPECT_TRUE(right.empty());
+    EXPECT_EQ(joined.size(), 100);
+    EXPECT_EQ(joined.select(40), std::make_pair(static_cast<int64_t>(40), std::string("40")));
+
+    EXPECT_EQ(joined.erase_range(10, 19), 10);
+    EXPECT_EQ(joined.erase_range(10, 19), 0);
+    EXPECT_EQ(joined.erase_range(19, 10), 0);
+    EXPECT_EQ(joined.size(), 90);
+    EXPECT_FALSE(joined.search(15).first);
+    EXPECT_TRUE(joined.search(20).first);
+    EXPECT_EQ(joined.count_range(0, 30), 21);
+
+    auto extracted = joined.extract_range(50, 59);
+    EXPECT_EQ(extracted.size(), 10);
+    EXPECT_EQ(joined.size(), 80);
+    EXPECT_EQ(extracted.min(), std::make_pair(static_cast<int64_t>(50), std::string("50")));
+    EXPECT_EQ(extracted.max(), std::make_pair(static_cast<int64_t>(59), std::string("59")));
+    EXPECT_FALSE(joined.search(55).first);
+
+    auto moved = joined.split(60);
+    auto tail = Tree::join(std::move(extracted), std::move(moved));
+    EXPECT_EQ(tail.size(), 50);
+
+    Tree other;
+    for (int64_t i = 1000; i < 1010; ++i) {
+        other.add(i, std::to_string(i));
+    }
+    auto shared = other.split(1005);
+    auto merged = Tree::join(std::move(tail), std::move(other));
+    merged = Tree::join(std::move(merged), std::move(shared));
+    EXPECT_EQ(merged.size(), 60);
+    for (int64_t i = 50; i < 100; ++i) {
+        EXPECT_EQ(merged.search(i), std::make_pair(true, std::to_string(i)));
+        EXPECT_EQ(merged.rank(i), i - 50);
+    }
+    EXPECT_EQ(merged.select(55), std::make_pair(static_cast<int64_t>(1005), std::string("1005")));
+    EXPECT_EQ(merged.max().first, 1009);
+    joined.clear();
+    merged.add(-1, "");
+    EXPECT_EQ(merged.min().first, -1);
+}
+
+TEST(SplayTree_Test, Split_join) {
+    check_split_join<BottomUpSplay>();
+    check_split_join<TopDownSplay>();
+}
+
+template<class Policy>
+void check_iteration() {
+    SplayTree<int64_t, std::string, Policy> spt;
+    EXPECT_EQ(spt.begin(), spt.end());
+    EXPECT_EQ(spt.lower_bound(0), spt.end());
+
+    std::map<int64_t, std::string> expected;
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int64_t> keys(-300, 300);
+    for (size_t i = 0; i < 200; ++i) {
+        auto key = keys(gen);
+        if (expected.emplace(key, std::to_string(key)).second) {
+            spt.add(key, std::to_string(key));
+        }
+    }
+
+    auto it = spt.begin();
+    for (auto &item: expected) {
+        ASSERT_NE(it, spt.end());
+        EXPECT_EQ(it.key(), item.first);
+        EXPECT_EQ(it.value(), item.second);
+        ++it;
+    }
+    EXPECT_EQ(it, spt.end());
+
+    auto rit = expected.rbegin();
+    for (auto back = spt.rbegin(); back != spt.rend(); ++back, ++rit) {
+        EXPECT_EQ((*back).first, rit->first);
+    }
+    EXPECT_EQ(rit, expected.rend());
+
+    for (auto [key, value]: spt) {
+        value += "!";
+    }
+    const auto &const_spt = spt;
+    for (auto [key, value]: const_spt) {
+        EXPECT_EQ(value, std::to_string(key) + "!");
+    }
+
+    for (int64_t probe = -310; probe <= 310; probe += 7) {
+        auto lower = expected.lower_bound(probe);
+        auto found = spt.lower_bound(probe);
+        if (lower == expected.end()) {
+            EXPECT_EQ(found, spt.end());
+        } else {
+            EXPECT_EQ(found.key(), lower->first);
+        }
+        auto upper = expected.upper_bound(probe);
+        found = spt.upper_bound(probe);
+        if (upper == expected.end()) {
+            EXPECT_EQ(found, spt.end());
+        } else {
+            EXPECT_EQ(found.key(), upper->first);
+            --found;
+            if (upper == expected.begin()) {
+                EXPECT_EQ(found, spt.end());
+            } else {
+                EXPECT_EQ(found.key(), std::prev(upper)->first);
+            }
+        }
+        std::vector<int64_t> scanned;
+        auto count = spt.scan(probe, probe + 50, [&scanned](const int64_t &key, std::string &) {
+            scanned.push_back(key);
+        });
+        std::vector<int64_t> range;
+        for (auto item = expected.lower_bound(probe); item != expected.upper_bound(probe + 50); ++item) {
+            range.push_back(item->first);
+        }
+        EXPECT_EQ(scanned, range);
+        EXPECT_EQ(count, range.size());
+    }
+}
+
+TEST(SplayTree_Test, Iterators) {
+    check_iteration<BottomUpSplay>();
+    check_iteration<TopDownSplay>();
+
+    SplayTree<> scanned;
+    SplayTree<> bounded;
+    for (int64_t i = 0; i < 64; ++i) {
+        scanned.add(i * 7 % 64, "");
+        bounded.add(i * 7 % 64, "");
+    }
+    EXPECT_EQ(scanned.scan(10, 50, [](const int64_t &, std::string &) {}), 41);
+    bounded.lower_bound(10);
+    std::stringstream scanned_out;
+    std::stringstream bounded_out;
+    scanned_out << scanned;
+    bounded_out << bounded;
+    EXPECT_EQ(scanned_out.str(), bounded_out.str());
+}
+
+TEST(SplayTree_Test, Build) {
+    std::vector<std::pair<int64_t, std::string>> sorted;
+    for (int64_t i = 1; i < 8; ++i) {
+        sorted.emplace_back(i, std::string(1, static_cast<char>('a' + i - 1)));
+    }
+    auto spt = SplayTree<>::build(sorted.begin(), sorted.end());
+    std::stringstream out;
+    out << spt;
+    EXPECT_EQ(out.str(), "[4 d]\n[2 b 4] [6 f 4]\n[1 a 2] [3 c 2] [5 e 6] [7 g 6]\n");
+    EXPECT_EQ(spt.size(), 7);
+    EXPECT_EQ(spt.select(2), std::make_pair(static_cast<int64_t>(3), std::string("c")));
+
+    std::list<std::pair<int64_t, std::string>> unsorted{{5, "e"}, {-1, "z"}, {3, "c"}, {10, "j"}};
+    auto top_down = SplayTree<int64_t, std::string, TopDownSplay>::build(unsorted.begin(), unsorted.end());
+    EXPECT_EQ(top_down.size(), 4);
+    EXPECT_EQ(top_down.min(), std::make_pair(static_cast<int64_t>(-1), std::string("z")));
+    EXPECT_EQ(top_down.rank(5), 2);
+    top_down.add(4, "d");
+    EXPECT_EQ(top_down.select(3), std::make_pair(static_cast<int64_t>(5), std::string("e")));
+
+    std::vector<std::pair<int64_t, std::string>> shuffled;
+    for (int64_t i = 0; i < 100000; ++i) {
+        shuffled.emplace_back(i * 7919 % 100000, "");
+    }
+    auto big = SplayTree<>::build(shuffled.begin(), shuffled.end());
+    EXPECT_EQ(big.size(), 100000);
+    int64_t expected_key = 0;
+    for (auto it = big.begin(); it != big.end(); ++it, ++expected_key) {
+        ASSERT_EQ(it.key(), expected_key);
+    }
+
+    sorted.emplace_back(7, "dup");
+    EXPECT_THROW(SplayTree<>::build(sorted.begin(), sorted.end()), std::logic_error);
+    auto empty = SplayTree<>::build(sorted.end(), sorted.end());
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(SplayTree_Test, Freeze) {
+    SplayTree<> spt;
+    EXPECT_TRUE(spt.freeze().empty());
+    EXPECT_THROW(spt.freeze().min(), std::logic_error);
+    for (int64_t i = 0; i < 10; ++i) {
+        spt.add(i * 3 % 1000 * 2, std::to_string(i));
+    }
+    std::stringstream before;
+    before << spt;
+    EXPECT_EQ(spt.freeze().size(), 10);
+    std::stringstream after;
+    after << spt;
+    EXPECT_EQ(before.str(), after.str());
+
+    for (int64_t i = 10; i < 1000; ++i) {
+        spt.add(i * 3 % 1000 * 2, std::to_string(i));
+    }
+    const auto frozen = spt.freeze();
+    EXPECT_EQ(frozen.size(), 1000);
+    EXPECT_EQ(frozen.min(), spt.min());
+    EXPECT_EQ(frozen.max(), spt.max());
+
+    spt.set(0, "changed");
+    EXPECT_EQ(frozen.search(0), std::make_pair(true, std::string("0")));
+
+    std::vector<std::thread> readers;
+    std::vector<size_t> found(4);
+    for (size_t t = 0; t < found.size(); ++t) {
+        readers.emplace_back([&frozen, &found, t]() {
+            for (int64_t key = -1; key <= 2000; ++key) {
+                if (frozen.find(key)) {
+                    ++found[t];
+                }
+            }
+        });
+    }
+    for (auto &reader: readers) {
+        reader.join();
+    }
+    for (auto count: found) {
+        EXPECT_EQ(count, 1000);
+    }
+    for (int64_t key = 0; key < 2000; key += 2) {
+        auto value = frozen.find(key);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, key == 0 ? "0" : spt.search(key).second);
+        EXPECT_EQ(frozen.find(key + 1), nullptr);
+    }
+
+    std::vector<std::pair<int64_t, std::string>> unsorted{{2, "b"}, {1, "a"}};
+    EXPECT_THROW(FrozenTree<>(unsorted.begin(), unsorted.end()), std::logic_error);
+}
+
+TEST(SplayTree_Test, Sharded) {
+    EXPECT_THROW(ShardedSplayTree<>(0), std::invalid_argument);
+    EXPECT_THROW(ShardedSplayTree<>(std::vector<int64_t>{10, 5}), std::invalid_argument);
+
+    ShardedSplayTree<> hashed(8);
+    ShardedSplayTree<> ranged(std::vector<int64_t>{1000, 2000, 3000});
+    EXPECT_EQ(ranged.shard_count(), 4);
+    EXPECT_THROW(hashed.min(), std::logic_error);
+    EXPECT_THROW(ranged.max(), std::logic_error);
+
+    std::vector<std::thread> writers;
+    for (int64_t t = 0; t < 4; ++t) {
+        writers.emplace_back([&hashed, &ranged, t]() {
+            for (int64_t key = t; key < 4000; key += 4) {
+                hashed.add(key, std::to_string(key));
+                ranged.add(key, std::to_string(key));
+                if (key % 3 == 0) {
+                    hashed.search(key);
+                    ranged.remove(key);
+                }
+            }
+        });
+    }
+    for (auto &writer: writers) {
+        writer.join();
+    }
+    EXPECT_EQ(hashed.size(), 4000);
+    EXPECT_EQ(ranged.size(), 4000 - 1334);
+    EXPECT_EQ(hashed.min(), std::make_pair(static_cast<int64_t>(0), std::string("0")));
+    EXPECT_EQ(hashed.max(), std::make_pair(static_cast<int64_t>(3999), std::string("3999")));
+    EXPECT_EQ(ranged.min(), std::make_pair(static_cast<int64_t>(1), std::string("1")));
+    EXPECT_EQ(ranged.max(), std::make_pair(static_cast<int64_t>(3998), std::string("3998")));
+    EXPECT_THROW(hashed.add(5, "5"), std::logic_error);
+    hashed.set(5, "five");
+    EXPECT_EQ(hashed.search(5), std::make_pair(true, std::string("five")));
+    EXPECT_FALSE(ranged.search(3).first);
+    const auto &const_ranged = ranged;
+    EXPECT_EQ(const_ranged.size(), 4000 - 1334);
+    EXPECT_FALSE(const_ranged.empty());
+    hashed.clear();
+    EXPECT_TRUE(hashed.empty());
+}
+
+template<class Policy>
+size_t check_policy() {
+    SplayTree<int64_t, std::string, Policy> spt;
+    std::map<int64_t, std::string> expected;
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int64_t> keys(0, 2000);
+    for (size_t i = 0; i < 20000; ++i) {
+        auto key = keys(gen);
+        switch (gen() % 4) {
+            case 0:
+                if (expected.emplace(key, std::to_string(i)).second) {
+                    spt.add(key, std::to_string(i));
+                }
+                break;
+            case 1:
+                if (expected.erase(key)) {
+                    spt.remove(key);
+                }
+                break;
+            case 2:
+                if (expected.count(key)) {
+                    expected[key] = std::to_string(i);
+                    spt.set(key, std::to_string(i));
+                }
+                break;
+            default:
+                EXPECT_EQ(spt.search(key).first, expected.count(key) == 1);
+        }
+        if (!expected.empty() && i % 50 == 0) {
+            EXPECT_EQ(spt.min().first, expected.begin()->first);
+            EXPECT_EQ(spt.max().first, expected.rbegin()->first);
+            EXPECT_EQ(spt.rank(key), std::distance(expected.begin(), expected.lower_bound(key)));
+        }
+    }
+    EXPECT_EQ(spt.size(), expected.size());
+    auto it = spt.begin();
+    for (auto &item: expected) {
+        EXPECT_EQ(it.key(), item.first);
+        EXPECT_EQ(it.value(), item.second);
+        ++it;
+    }
+    return spt.rotations();
+}
+
+TEST(SplayTree_Test, Policies) {
+    auto full = check_policy<BottomUpSplay>();
+    auto semi = check_policy<SemiSplay>();
+    auto threshold = check_policy<DepthThresholdSplay<16>>();
+    auto random = check_policy<RandomSplay<std::ratio<1, 4>>>();
+    EXPECT_GT(check_policy<TopDownSplay>(), 0);
+    EXPECT_GT(full, 0);
+    EXPECT_LT(semi, full);
+    EXPECT_LT(threshold, full);
+    EXPECT_LT(random, full);
+
+    SplayTree<int64_t, std::string, DepthThresholdSplay<2>> shallow;
+    shallow.add(2, "b");
+    shallow.add(1, "a");
+    shallow.add(3, "c");
+    auto before = shallow.rotations();
+    std::stringstream out_before;
+    out_before << shallow;
+    EXPECT_TRUE(shallow.search(1).first);
+    EXPECT_TRUE(shallow.search(2).first);
+    std::stringstream out_after;
+    out_after << shallow;
+    EXPECT_EQ(shallow.rotations(), before);
+    EXPECT_EQ(out_before.str(), out_after.str());
+}
+
+struct CopyCounter {
+    /*
+     * значение, считающее свои копирования
+     */
+    static size_t copies;
+    std::string text;
+
+    explicit CopyCounter(std::string s = "") : text(std::move(s)) {}
+
+    CopyCounter(const CopyCounter &other) : text(other.text) {
+        ++copies;
+    }
+
+    CopyCounter(CopyCounter &&other) noexcept = default;
+
+    CopyCounter &operator=(const CopyCounter &other) {
+        text = other.text;
+        ++copies;
+        return *this;
+    }
+
+    CopyCounter &operator=(CopyCounter &&other) noexcept = default;
+};
+
+size_t CopyCounter::copies = 0;
+
+template<class Policy>
+void check_zero_copy() {
+    SplayTree<int64_t, CopyCounter, Policy> spt;
+    CopyCounter::copies = 0;
+    for (int64_t i = 0; i < 100; ++i) {
+        spt.add(std::move(i), CopyCounter(std::to_string(i)));
+    }
+    EXPECT_EQ(spt.emplace(100, "100").text, "100");
+    EXPECT_THROW(spt.emplace(50, "dup"), std::logic_error);
+    spt.set(7, CopyCounter("seven"));
+    for (int64_t i = 0; i <= 100; ++i) {
+        auto value = spt.find(i);
+        ASSERT_NE(value, nullptr);
+        ASSERT_EQ(value->text, i == 7 ? "seven" : std::to_string(i));
+    }
+    EXPECT_EQ(spt.find(101), nullptr);
+    EXPECT_FALSE(spt.get(-1).has_value());
+    spt.get(3)->get().text = "three";
+    EXPECT_EQ(spt.find(3)->text, "three");
+    EXPECT_EQ(spt.find_min().value().text, "0");
+    EXPECT_EQ(spt.find_max().key(), 100);
+    EXPECT_EQ(CopyCounter::copies, 0);
+
+    EXPECT_THROW(spt.set(200, CopyCounter("none")), std::logic_error);
+    spt.clear();
+    EXPECT_EQ(spt.find_min(), spt.end());
+    EXPECT_EQ(spt.find_max(), spt.end());
+}
+
+TEST(SplayTree_Test, Zero_copy) {
+    check_zero_copy<BottomUpSplay>();
+    check_zero_copy<TopDownSplay>();
+
+    SplayTree<int64_t, std::unique_ptr<int>> owners;
+    owners.add(1, std::make_unique<int>(10));
+    owners.emplace(2, new int(20));
+    owners.set(1, std::make_unique<int>(11));
+    EXPECT_EQ(**owners.find(1), 11);
+    EXPECT_EQ(**owners.find(2), 20);
+    EXPECT_EQ(owners.find(3), nullptr);
+}
+
+TEST(SplayTree_Test, Finger) {
+    SplayTree<> spt;
+    EXPECT_EQ(spt.search_near(1), spt.end());
+    EXPECT_EQ(spt.next_after(), spt.end());
+    for (int64_t i = 0; i < 1000; ++i) {
+        spt.add(i * 2, std::to_string(i));
+    }
+    for (int64_t i = 0; i < 1000; ++i) {
+        auto it = spt.search_near(i * 2);
+        ASSERT_NE(it, spt.end());
+        ASSERT_EQ(it.value(), std::to_string(i));
+        ASSERT_EQ(spt.search_near(i * 2 + 1), spt.end());
+    }
+
+    auto first = spt.search_near(0);
+    auto rotations = spt.rotations();
+    int64_t expected_key = 0;
+    for (auto it = first; it != spt.end(); it = spt.next_after(it), expected_key += 2) {
+        ASSERT_EQ(it.key(), expected_key);
+    }
+    EXPECT_EQ(expected_key, 2000);
+    EXPECT_EQ(spt.rotations(), rotations);
+
+    spt.search_near(10);
+    EXPECT_EQ(spt.next_after().key(), 12);
+    EXPECT_EQ(spt.next_after().key(), 14);
+    spt.remove(14);
+    EXPECT_EQ(spt.next_after().key(), 0);
+    EXPECT_EQ(spt.next_after().key(), 2);
+
+    std::map<int64_t, std::string> oracle;
+    for (auto it = spt.begin(); it != spt.end(); ++it) {
+        oracle.emplace(it.key(), it.value());
+    }
+    std::mt19937 generator(7);
+    for (int i = 0; i < 20000; ++i) {
+        auto key = static_cast<int64_t>(generator() % 3000);
+        auto it = spt.search_near(key);
+        auto expected = oracle.find(key);
+        ASSERT_EQ(it != spt.end(), expected != oracle.end());
+        if (it != spt.end()) {
+            ASSERT_EQ(it.value(), expected->second);
+        }
+        if (i % 3 == 0) {
+            if (expected == oracle.end()) {
+                spt.add(key, "x");
+                oracle.emplace(key, "x");
+            } else {
+                spt.remove(key);
+                oracle.erase(expected);
+            }
+        }
+    }
+    EXPECT_EQ(spt.size(), oracle.size());
+}
+
+TEST(SplayTree_Test, Join_finger) {
+    // после склейки палец right не должен указывать на узлы, которые теперь принадлежат left или удалены
+    SplayTree<> left;
+    SplayTree<> right;
+    for (int64_t i = 0; i < 100; ++i) {
+        left.add(i, std::to_string(i));
+        right.add(i + 100, std::to_string(i + 100));
+    }
+    right.search_near(150);
+    auto merged = SplayTree<>::join(std::move(left), std::move(right));  // пул right вливается в пул left
+    EXPECT_TRUE(right.empty());
+    EXPECT_EQ(right.search_near(150), right.end());
+    EXPECT_EQ(right.next_after(), right.end());
+    EXPECT_EQ(merged.search_near(150).value(), "150");
+
+    SplayTree<> head;
+    SplayTree<> whole;
+    for (int64_t i = 0; i < 100; ++i) {
+        head.add(i, std::to_string(i));
+        whole.add(i + 100, std::to_string(i + 100));
+    }
+    auto tail = whole.split(150);  // tail делит пул с whole, поэтому узлы переносятся поштучно
+    tail.search_near(170);
+    auto relocated = SplayTree<>::join(std::move(head), std::move(tail));
+    EXPECT_TRUE(tail.empty());
+    EXPECT_EQ(tail.search_near(170), tail.end());
+    EXPECT_EQ(tail.next_after(), tail.end());
+    EXPECT_EQ(relocated.search_near(170).value(), "170");
+    EXPECT_EQ(relocated.search_near(120), relocated.end());
+    EXPECT_EQ(whole.search_near(120).value(), "120");
+}
+
+template<size_t Degree>
+void check_btree() {
+    BTree<int64_t, std::string, Degree> bt;
+    std::map<int64_t, std::string> oracle;
+    std::mt19937 generator(Degree);
+    for (int i = 0; i < 20000; ++i) {
+        auto key = static_cast<int64_t>(generator() % 2000);
+        auto expected = oracle.find(key);
+        switch (generator() % 4) {
+            case 0:
+            case 1:
+                if (expected == oracle.end()) {
+                    bt.add(key, std::to_string(i));
+                    oracle.emplace(key, std::to_string(i));
+                } else {
+                    ASSERT_THROW(bt.add(key, ""), std::logic_error);
+                }
+                break;
+            case 2:
+                if (expected == oracle.end()) {
+                    ASSERT_THROW(bt.remove(key), std::logic_error);
+                } else {
+                    bt.remove(key);
+                    oracle.erase(expected);
+                }
+                break;
+            default:
+                ASSERT_EQ(bt.search(key).first, expected != oracle.end());
+                if (expected != oracle.end()) {
+                    bt.set(key, "set");
+                    expected->second = "set";
+                }
+        }
+        ASSERT_EQ(bt.size(), oracle.size());
+    }
+    auto expected = oracle.begin();
+    for (auto it = bt.begin(); it != bt.end(); ++it, ++expected) {
+        ASSERT_EQ(it.key(), expected->first);
+        ASSERT_EQ(it.value(), expected->second);
+    }
+    EXPECT_EQ(expected, oracle.end());
+    EXPECT_EQ(bt.min().first, oracle.begin()->first);
+    EXPECT_EQ(bt.max().first, oracle.rbegin()->first);
+    size_t k = 0;
+    for (auto &item: oracle) {
+        ASSERT_EQ(bt.rank(item.first), k);
+        ASSERT_EQ(bt.select(k).first, item.first);
+        ++k;
+    }
+    EXPECT_EQ(bt.count_range(100, 1099), std::distance(oracle.lower_bound(100), oracle.upper_bound(1099)));
+    EXPECT_THROW(bt.select(oracle.size()), std::out_of_range);
+    while (!oracle.empty()) {
+        bt.remove(oracle.begin()->first);
+        oracle.erase(oracle.begin());
+    }
+    EXPECT_TRUE(bt.empty());
+    EXPECT_THROW(bt.min(), std::logic_error);
+}
+
+template<class Policy>
+void check_snapshot() {
+    const std::string path = "snapshot_test.bin";
+    SplayTree<int64_t, std::string, Policy> spt;
+    for (int64_t i = 0; i < 10000; ++i) {
+        spt.add(i * 7919 % 10000 - 5000, std::string(static_cast<size_t>(i % 5), 'a'));
+    }
+    spt.save(path);
+
+    SplayTree<int64_t, std::string, Policy> loaded;
+    loaded.add(100000, "old");
+    loaded.load(path);
+    EXPECT_EQ(loaded.size(), spt.size());
+    EXPECT_EQ(loaded.search(100000).first, false);
+    auto expected = spt.begin();
+    for (auto it = loaded.begin(); it != loaded.end(); ++it, ++expected) {
+        ASSERT_EQ(it.key(), expected.key());
+        ASSERT_EQ(it.value(), expected.value());
+    }
+    EXPECT_EQ(loaded.select(5000).first, 0);
+    loaded.add(100000, "new");
+    EXPECT_EQ(loaded.max(), std::make_pair(static_cast<int64_t>(100000), std::string("new")));
+
+    SplayTree<int64_t, std::string, Policy> empty;
+    empty.save(path);
+    loaded.load(path);
+    EXPECT_TRUE(loaded.empty());
+    std::remove(path.c_str());
+}
+
+TEST(SplayTree_Test, Snapshot) {
+    check_snapshot<BottomUpSplay>();
+    check_snapshot<TopDownSplay>();
+
+    const std::string path = "snapshot_test.bin";
+    SplayTree<int64_t, double> numbers;
+    numbers.add(2, 0.5);
+    numbers.add(1, -1.25);
+    numbers.save(path);
+    SplayTree<int64_t, double> loaded;
+    loaded.load(path);
+    EXPECT_EQ(loaded.search(1).second, -1.25);
+    EXPECT_EQ(loaded.search(2).second, 0.5);
+
+    SplayTree<> strings;
+    strings.add(1, "one");
+    strings.add(2, "two");
+    strings.save(path);
+    std::string bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 1));
+    }
+    EXPECT_THROW(strings.load(path), std::runtime_error);
+    EXPECT_EQ(strings.size(), 2);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        file.put('\0');
+    }
+    EXPECT_THROW(strings.load(path), std::runtime_error);
+    {
+        // ключи 1 и 2 меняются местами: порядок ключей нарушен
+        auto unordered = bytes;
+        constexpr size_t keys = 8 + 2 * sizeof(uint64_t);
+        std::swap_ranges(unordered.begin() + keys, unordered.begin() + keys + sizeof(int64_t),
+                         unordered.begin() + keys + sizeof(int64_t));
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(unordered.data(), static_cast<std::streamsize>(unordered.size()));
+    }
+    EXPECT_THROW(strings.load(path), std::runtime_error);
+    EXPECT_EQ(strings.size(), 2);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    strings.load(path);
+    EXPECT_EQ(strings.search(2).second, "two");
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "not a snapshot at all";
+    }
+    EXPECT_THROW(strings.load(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(strings.load(path), std::runtime_error);
+    EXPECT_THROW(strings.save("no_such_directory/snapshot.bin"), std::runtime_error);
+}
+
+TEST(SplayTree_Test, BTree) {
+    check_btree<2>();
+    check_btree<3>();
+    check_btree<8>();
+
+    BTree<int64_t, std::string, 2> bt;
+    for (int64_t i = 1; i < 8; ++i) {
+        bt.add(i, std::string(1, static_cast<char>('a' + i - 1)));
+    }
+    std::stringstream out;
+    out << bt;
+    EXPECT_EQ(out.str(), "[2 b 4 d]\n[1 a] [3 c] [5 e 6 f 7 g]\n");
+    const auto &view = bt;
+    EXPECT_EQ(*view.find(5), "e");
+    EXPECT_EQ(view.find(8), nullptr);
+    EXPECT_EQ(view.find_max().value(), "g");
+
+    std::stringstream commands;
+    commands << "add 5 five\nadd 3 three\nadd 5 again\nsearch 3\nsearch 4\nmin\nmax\nset 3 tres\nrank 5\n"
+                "select 0\ncount 1 10\ndelete 3\ndelete 3\nsearch 3\nmin\ndelete 5\nmax\n";
+    std::stringstream splay_out;
+    std::stringstream btree_out;
+    std::stringstream btree_commands(commands.str());
+    handler(splay_out, commands);
+    BTree<int64_t, std::string> commands_tree;
+    run_commands(commands_tree, btree_out, btree_commands);
+    EXPECT_EQ(btree_out.str(), splay_out.str());
+    EXPECT_EQ(btree_out.str(), "error\n1 three\n0\n3 three\n5 five\n1\n3 tres\n2\nerror\n0\n5 five\nerror\n");
+}
+
 TEST(SplayTree_Test, Handler) {
     std::stringstream out_stream;
     std::stringstream answer_stream;
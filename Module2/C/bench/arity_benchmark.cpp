@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <random>
+
+#include "minheap.hpp"
+
+/// сравнение 2-, 4- и 8-арных куч, а также индексов ключей: FlatIndex (по умолчанию) и DenseIndex
+/// первая нагрузка - команды add/extract/delete/search из файла (по умолчанию tests/input/input18.txt),
+/// повторенные несколько раз; вторая - добавление и извлечение миллиона случайных ключей; третья - построение
+/// кучи из тех же ключей методом build
+/// аргументы (необязательные): путь к файлу команд, число повторов файла и число ключей
+
+struct Command {
+    char name;  // 'a' - add, 'e' - extract, 'd' - delete, 's' - search
+    int64_t key;
+};
+
+std::vector<Command> read_commands(const std::string &path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "File " << path << " was not open\n";
+    }
+    std::vector<Command> commands;
+    std::string line;
+    std::string name;
+    std::string key;
+    std::string value;
+    std::string dump;
+    while (getline(file, line)) {
+        parser(line, name, key, value, dump);
+        if (name == "extract") {
+            commands.push_back({'e', 0});
+        } else if ((name == "add" || name == "delete" || name == "search") && !key.empty()) {
+            commands.push_back({name[0] == 'a' ? 'a' : name[0] == 'd' ? 'd' : 's', std::stoll(key)});
+        }
+    }
+    return commands;
+}
+
+template<class Heap>
+double replay(const std::vector<Command> &commands, size_t rounds) {
+    auto start = std::chrono::steady_clock::now();
+    size_t checksum = 0;
+    for (size_t round = 0; round < rounds; ++round) {
+        Heap heap;
+        for (auto &command: commands) {
+            try {
+                switch (command.name) {
+                    case 'a':
+                        heap.add(command.key, "value");
+                        break;
+                    case 'e':
+                        checksum += static_cast<size_t>(heap.extract().key);
+                        break;
+                    case 'd':
+                        heap.remove(command.key);
+                        break;
+                    default:
+                        checksum += heap.index(command.key);
+                }
+            } catch (std::logic_error &) {
+                ++checksum;
+            }
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (!checksum) {
+        std::cerr << "empty trace\n";
+    }
+    return elapsed.count();
+}
+
+template<class Heap>
+std::pair<double, double> add_extract(const std::vector<int64_t> &keys) {
+    Heap heap;
+    auto start = std::chrono::steady_clock::now();
+    for (auto key: keys) {
+        heap.add(key, "value");
+    }
+    auto middle = std::chrono::steady_clock::now();
+    int64_t previous = std::numeric_limits<int64_t>::min();
+    while (!heap.empty()) {
+        auto key = heap.extract().key;
+        if (key < previous) {
+            std::cerr << "wrong order\n";
+        }
+        previous = key;
+    }
+    std::chrono::duration<double> adding = middle - start;
+    std::chrono::duration<double> extracting = std::chrono::steady_clock::now() - middle;
+    return std::make_pair(adding.count(), extracting.count());
+}
+
+template<class Heap>
+double build(const std::vector<int64_t> &keys) {
+    std::vector<typename Heap::Node> nodes;
+    nodes.reserve(keys.size());
+    for (auto key: keys) {
+        nodes.emplace_back(key, "value");
+    }
+    Heap heap;
+    auto start = std::chrono::steady_clock::now();
+    heap.build(nodes.begin(), nodes.end());
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (heap.size() != keys.size()) {
+        std::cerr << "lost keys\n";
+    }
+    return elapsed.count();
+}
+
+template<size_t Arity, class Index = FlatIndex<int64_t, uint32_t>>
+void run(const std::string &name, const std::vector<Command> &commands, size_t rounds,
+         const std::vector<int64_t> &keys) {
+    using Heap = MinHeap<int64_t, std::string, Arity, Index>;
+    auto file_time = replay<Heap>(commands, rounds);
+    auto times = add_extract<Heap>(keys);
+    std::cout << std::setw(12) << name << std::setw(12) << file_time << std::setw(12) << times.first
+              << std::setw(12) << times.second << std::setw(12) << build<Heap>(keys) << '\n';
+}
+
+int main(int argc, char *argv[]) {
+    std::string path = argc > 1 ? argv[1] : "../tests/input/input18.txt";
+    size_t rounds = argc > 2 ? std::stoul(argv[2]) : 20;
+    size_t count = argc > 3 ? std::stoul(argv[3]) : 1000000;
+    auto commands = read_commands(path);
+    std::vector<int64_t> keys(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys[i] = static_cast<int64_t>(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+    std::cout << std::setw(12) << "heap" << std::setw(12) << "file, s" << std::setw(12) << "add, s" << std::setw(12)
+              << "extract, s" << std::setw(12) << "build, s" << '\n' << std::fixed << std::setprecision(3);
+    run<2>("2-ary", commands, rounds, keys);
+    run<4>("4-ary", commands, rounds, keys);
+    run<8>("8-ary", commands, rounds, keys);
+    run<2, DenseIndex<int64_t>>("2-ary dense", commands, rounds, keys);
+    run<4, DenseIndex<int64_t>>("4-ary dense", commands, rounds, keys);
+    return 0;
+}
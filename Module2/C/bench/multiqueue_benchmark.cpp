@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+
+#include "minheap.hpp"
+#include "multiqueue.hpp"
+
+/// пропускная способность MultiQueue против одной MinHeap под мьютексом: каждый поток поочередно добавляет
+/// и извлекает элементы со случайными приоритетами; затем - ранг ошибки извлечения MultiQueue при разном числе
+/// шардов (однопоточно, ранг - число элементов очереди с меньшим приоритетом)
+/// аргументы (необязательные): число операций на поток (по умолчанию 1000000) и максимальное число потоков
+
+constexpr size_t prefill = 100000;
+
+class LockedHeap {
+    /// одна куча под общим мьютексом
+public:
+    void add(const int64_t &key, const int64_t &value, const int64_t &priority) {
+        std::lock_guard<std::mutex> guard(lock);
+        heap.add(key, value, priority);
+    }
+
+    bool try_extract(HeapNode<int64_t, int64_t> &node) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (heap.empty()) {
+            return false;
+        }
+        node = heap.extract();
+        return true;
+    }
+
+private:
+    std::mutex lock;
+    MinHeap<int64_t, int64_t, 2, NoIndex<int64_t>> heap;
+};
+
+template<class Queue>
+double throughput(Queue &queue, size_t threads, size_t operations) {
+    /// миллионов операций в секунду
+    std::mt19937_64 gen(1);
+    for (size_t i = 0; i < prefill; ++i) {
+        queue.add(static_cast<int64_t>(i), 0, static_cast<int64_t>(gen() % 1000000000));
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&queue, t, operations] {
+            std::mt19937_64 local(t + 2);
+            HeapNode<int64_t, int64_t> node;
+            for (size_t i = 0; i < operations; ++i) {
+                if (i % 2) {
+                    queue.try_extract(node);
+                } else {
+                    queue.add(static_cast<int64_t>(i), 0, static_cast<int64_t>(local() % 1000000000));
+                }
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(threads * operations) / elapsed.count() / 1e6;
+}
+
+std::pair<double, size_t> rank_error(size_t shards, size_t operations) {
+    /// средний и наибольший ранг ошибки
+    MultiQueue<int64_t, int64_t> queue(shards, 1);
+    std::multiset<int64_t> present;
+    std::mt19937_64 gen(3);
+    for (size_t i = 0; i < prefill / 10; ++i) {
+        auto priority = static_cast<int64_t>(gen() % 1000000000);
+        queue.add(static_cast<int64_t>(i), 0, priority);
+        present.insert(priority);
+    }
+    size_t total = 0;
+    size_t worst = 0;
+    for (size_t i = 0; i < operations; ++i) {
+        auto top = queue.extract();
+        auto rank = static_cast<size_t>(std::distance(present.begin(), present.lower_bound(top.priority)));
+        total += rank;
+        worst = std::max(worst, rank);
+        present.erase(present.find(top.priority));
+        auto priority = static_cast<int64_t>(gen() % 1000000000);
+        queue.add(static_cast<int64_t>(i), 0, priority);
+        present.insert(priority);
+    }
+    return std::make_pair(static_cast<double>(total) / static_cast<double>(operations), worst);
+}
+
+int main(int argc, char *argv[]) {
+    size_t operations = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t max_threads = argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "locked, Mops/s" << std::setw(20)
+              << "multiqueue, Mops/s" << '\n';
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        LockedHeap locked;
+        MultiQueue<int64_t, int64_t> relaxed(threads);
+        auto locked_rate = throughput(locked, threads, operations);
+        std::cout << std::setw(8) << threads << std::setw(16) << locked_rate << std::setw(20)
+                  << throughput(relaxed, threads, operations) << '\n';
+    }
+
+    std::cout << '\n' << std::setw(8) << "shards" << std::setw(16) << "mean rank" << std::setw(20) << "max rank"
+              << '\n';
+    for (size_t shards = 1; shards <= 2 * max_threads; shards *= 2) {
+        auto error = rank_error(shards, operations / 10);
+        std::cout << std::setw(8) << shards << std::setw(16) << error.first << std::setw(20) << error.second << '\n';
+    }
+    return 0;
+}
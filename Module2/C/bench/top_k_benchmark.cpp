@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+#include "minheap.hpp"
+#include "top_k.hpp"
+
+/// отбор K наибольших оценок из потока событий: TopK фиксированной емкости против MinHeap, в которую
+/// добавляется весь поток (событие - ключ, оценка - приоритет) с последующим извлечением всех, кроме K
+/// аргументы (необязательные): длина потока (по умолчанию 2000000) и K (по умолчанию 1000)
+
+std::vector<int64_t> stream(size_t length) {
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int64_t> uniform(0, 1000000000);
+    std::vector<int64_t> scores(length);
+    for (auto &score: scores) {
+        score = uniform(gen);
+    }
+    return scores;
+}
+
+int64_t top_k(const std::vector<int64_t> &scores, size_t k) {
+    TopK<int64_t, int64_t> top(k);
+    for (size_t i = 0; i < scores.size(); ++i) {
+        top.add(static_cast<int64_t>(i), static_cast<int64_t>(i), scores[i]);
+    }
+    return top.drain_sorted().back().priority;
+}
+
+int64_t full_heap(const std::vector<int64_t> &scores, size_t k) {
+    MinHeap<int64_t, int64_t> heap;
+    for (size_t i = 0; i < scores.size(); ++i) {
+        heap.add(static_cast<int64_t>(i), static_cast<int64_t>(i), scores[i]);
+    }
+    while (heap.size() > k) {
+        heap.extract();
+    }
+    return heap.extract().priority;
+}
+
+template<class F>
+double measure(F function, const std::vector<int64_t> &scores, size_t k, int64_t &threshold) {
+    auto start = std::chrono::steady_clock::now();
+    threshold = function(scores, k);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char *argv[]) {
+    size_t length = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    size_t k = argc > 2 ? std::stoul(argv[2]) : 1000;
+    auto scores = stream(length);
+    int64_t top_threshold = 0;
+    int64_t full_threshold = 0;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(14) << "top-k, s" << std::setw(10) << measure(top_k, scores, k, top_threshold) << '\n';
+    std::cout << std::setw(14) << "full heap, s" << std::setw(10) << measure(full_heap, scores, k, full_threshold)
+              << '\n';
+    if (top_threshold != full_threshold) {
+        std::cerr << "different results\n";
+    }
+    return 0;
+}
@@ -1,6 +1,11 @@
 #include "minheap.hpp"
+#include "minmax_heap.hpp"
 
-int main() {
+int main(int argc, char *argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "minmax") {
+        handler<std::istream, std::ostream, MinMaxHeap<>>(std::cin, std::cout);
+        return 0;
+    }
     handler<std::istream, std::ostream>(std::cin, std::cout);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,46 @@
+#ifndef MINHEAP_CACHE_ALIGNED_ALLOCATOR_HPP
+#define MINHEAP_CACHE_ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+
+
+template<class T, size_t Shift = 0, size_t Alignment = 64>
+struct CacheAlignedAllocator {
+    /// аллокатор массивов, в которых по границе Alignment выровнено место с индексом -Shift: перед массивом
+    /// остается Shift неиспользуемых мест, и элемент j начинает кэш-линию, если (j + Shift) * sizeof(T)
+    /// кратно Alignment
+    /// в d-арной куче при Shift = d - 1 так выравниваются группы детей одного узла (индексы d * i + 1 .. d * i + d)
+    using value_type = T;
+
+    template<class U>
+    struct rebind {
+        using other = CacheAlignedAllocator<U, Shift, Alignment>;
+    };
+
+    CacheAlignedAllocator() noexcept = default;
+
+    template<class U>
+    explicit CacheAlignedAllocator(const CacheAlignedAllocator<U, Shift, Alignment> &) noexcept {}
+
+    T *allocate(size_t n) {
+        /// выделение памяти под n элементов и Shift мест перед ними
+        auto base = static_cast<T *>(::operator new((n + Shift) * sizeof(T), std::align_val_t{Alignment}));
+        return base + Shift;
+    }
+
+    void deallocate(T *p, size_t) noexcept {
+        ::operator delete(p - Shift, std::align_val_t{Alignment});
+    }
+
+    friend bool operator==(const CacheAlignedAllocator &, const CacheAlignedAllocator &) noexcept {
+        return true;
+    }
+
+    friend bool operator!=(const CacheAlignedAllocator &, const CacheAlignedAllocator &) noexcept {
+        return false;
+    }
+};
+
+
+#endif //MINHEAP_CACHE_ALIGNED_ALLOCATOR_HPP
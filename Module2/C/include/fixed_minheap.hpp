@@ -0,0 +1,282 @@
+#ifndef MINHEAP_FIXED_MINHEAP_HPP
+#define MINHEAP_FIXED_MINHEAP_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "minheap.hpp"
+
+
+template<class K, class V, size_t N>
+class FixedMinHeap {
+    /// двоичная куча емкостью N без обращений к аллокатору: все массивы - std::array внутри объекта
+    /// устройство как у MinHeap: в порядке кучи лежат приоритеты и номера ячеек, ключи и значения - в ячейках,
+    /// которые не перемещаются; индекс ключ -> ячейка - встроенная хеш-таблица с открытой адресацией
+    /// (линейное пробирование, размер - степень двойки не меньше 2N), в ней хранится только номер ячейки + 1
+    /// переполнение не приводит к перевыделению: try_add возвращает false, add вызывает исключение
+    /// для литеральных K и V (например, целых) кучу можно использовать в constexpr-вычислениях
+    static_assert(N > 0, "Capacity of fixed heap must be positive");
+    static_assert(N < std::numeric_limits<uint32_t>::max(), "Capacity of fixed heap is too large");
+
+public:
+    using Node = HeapNode<K, V>;
+
+    constexpr FixedMinHeap() noexcept {
+        for (size_t i = 0; i < N; ++i) {
+            free_slots[i] = static_cast<uint32_t>(N - 1 - i);
+        }
+    }
+
+    constexpr void add(const K &key, const V &value) {
+        /// метод добавления пары ключ-значение
+        /// если ключ уже добавлен в кучу или куча заполнена, будет вызвано исключение
+        add(key, value, key);
+    }
+
+    constexpr void add(const K &key, const V &value, const K &priority) {
+        /// метод добавления пары ключ-значение с отдельным приоритетом
+        /// если ключ уже добавлен в кучу или куча заполнена, будет вызвано исключение
+        if (!try_add(key, value, priority)) {
+            throw std::length_error{"Fixed heap is full"};
+        }
+    }
+
+    constexpr bool try_add(const K &key, const V &value, const K &priority) {
+        /// метод добавления без исключения при переполнении: возвращает false, если куча заполнена
+        /// если ключ уже добавлен в кучу, будет вызвано исключение
+        if (_find(key) != Table) {
+            throw std::logic_error{"This key have already added"};
+        }
+        if (count == N) {
+            return false;
+        }
+        auto slot = free_slots[N - 1 - count];
+        items[slot].key = key;
+        items[slot].value = value;
+        _insert(key, slot);
+        priorities[count] = priority;
+        slots[count] = slot;
+        positions[slot] = static_cast<uint32_t>(count);
+        ++count;
+        _heapify(count - 1);
+        return true;
+    }
+
+    constexpr size_t index(const K &key) const noexcept {
+        /// метод получения индекса по ключу
+        /// если ключа нет в куче, будет возвращено -1
+        auto cell = _find(key);
+        if (cell == Table) {
+            return -1;
+        }
+        return positions[table[cell] - 1];
+    }
+
+    constexpr Node min() const {
+        /// метод получения минимума без извлечения
+        /// если куча пустая, будет вызвано исключение
+        if (empty()) {
+            throw std::logic_error{"Cannot find min element in empty heap"};
+        }
+        auto &item = items[slots[0]];
+        return Node(item.key, item.value, priorities[0]);
+    }
+
+    constexpr Node extract() {
+        /// метод извлечения корня кучи
+        /// если куча пустая, будет вызвано исключение
+        if (empty()) {
+            throw std::logic_error{"Cannot extract from empty heap"};
+        }
+        auto &item = items[slots[0]];
+        auto cell = _find(item.key);
+        Node top(std::move(item.key), std::move(item.value), std::move(priorities[0]));
+        _erase(cell, 0);
+        return top;
+    }
+
+    constexpr void remove(const K &key) {
+        /// метод удаления узла по ключу
+        /// если ключа нет в куче, будет вызвано исключение
+        auto cell = _find(key);
+        if (cell == Table) {
+            throw std::logic_error{"Cannot remove from empty heap"};
+        }
+        _erase(cell, positions[table[cell] - 1]);
+    }
+
+    constexpr void update_priority(const K &key, const K &new_priority) {
+        /// метод изменения приоритета элемента с ключом key
+        /// если ключа нет в куче, будет вызвано исключение
+        auto cell = _find(key);
+        if (cell == Table) {
+            throw std::logic_error{"Cannot update priority of absent key"};
+        }
+        size_t ind = positions[table[cell] - 1];
+        auto increased = priorities[ind] < new_priority;
+        priorities[ind] = new_priority;
+        if (increased) {
+            _sift_down(ind);
+        } else {
+            _heapify(ind);
+        }
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        /// метод проверки, пустая ли куча
+        return !count;
+    }
+
+    [[nodiscard]] constexpr bool full() const noexcept {
+        /// метод проверки, заполнена ли куча
+        return count == N;
+    }
+
+    [[nodiscard]] constexpr size_t size() const noexcept {
+        /// метод получения числа элементов кучи
+        return count;
+    }
+
+    [[nodiscard]] static constexpr size_t capacity() noexcept {
+        /// метод получения емкости кучи
+        return N;
+    }
+
+private:
+    struct Item {
+        K key{};
+        V value{};
+    };
+
+    static constexpr size_t _table_size() noexcept {
+        /// размер таблицы индекса: степень двойки не меньше 2N
+        size_t size = 2;
+        while (size < 2 * N) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    static constexpr size_t _shift() noexcept {
+        /// сдвиг произведения хеша: остаются log2(Table) старших бит
+        size_t shift = 64;
+        for (auto size = _table_size(); size > 1; size /= 2) {
+            --shift;
+        }
+        return shift;
+    }
+
+    static constexpr size_t Table = _table_size();
+    static constexpr size_t Mask = Table - 1;
+    static constexpr size_t Shift = _shift();
+
+    std::array<Item, N> items{};
+    std::array<K, N> priorities{};            // приоритеты в порядке кучи
+    std::array<uint32_t, N> slots{};          // номера ячеек в порядке кучи
+    std::array<uint32_t, N> positions{};      // номер ячейки, индекс в куче
+    std::array<uint32_t, N> free_slots{};     // стек свободных ячеек в первых N - count местах
+    std::array<uint32_t, Table> table{};      // индекс: номер ячейки + 1, 0 - пусто
+    size_t count = 0;
+
+    static constexpr size_t _home(const K &key) noexcept {
+        /// домашняя ячейка индекса: старшие биты произведения хеша на 2^64 / phi
+        /// для целых ключей хеш - сам ключ (std::hash не constexpr)
+        uint64_t hash = 0;
+        if constexpr (std::is_integral_v<K>) {
+            hash = static_cast<uint64_t>(key);
+        } else {
+            hash = static_cast<uint64_t>(std::hash<K>{}(key));
+        }
+        return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> Shift);
+    }
+
+    constexpr size_t _find(const K &key) const noexcept {
+        /// номер клетки индекса с ключом или Table, если ключа нет
+        for (auto cell = _home(key); table[cell]; cell = (cell + 1) & Mask) {
+            if (items[table[cell] - 1].key == key) {
+                return cell;
+            }
+        }
+        return Table;
+    }
+
+    constexpr void _insert(const K &key, uint32_t slot) noexcept {
+        /// запись ячейки в индекс (ключа в индексе нет, свободная клетка есть всегда: N < Table)
+        auto cell = _home(key);
+        while (table[cell]) {
+            cell = (cell + 1) & Mask;
+        }
+        table[cell] = slot + 1;
+    }
+
+    constexpr void _erase(size_t cell, size_t ind) noexcept {
+        /// удаление элемента: клетка cell индекса (со сдвигом следующих клеток цепочки назад),
+        /// ячейка и место ind кучи, на которое встает последний элемент
+        auto slot = table[cell] - 1;
+        for (auto next = (cell + 1) & Mask; table[next]; next = (next + 1) & Mask) {
+            if (((next - _home(items[table[next] - 1].key)) & Mask) >= ((next - cell) & Mask)) {
+                table[cell] = table[next];
+                cell = next;
+            }
+        }
+        table[cell] = 0;
+        items[slot] = Item();
+        --count;
+        free_slots[N - 1 - count] = slot;
+        if (ind != count) {
+            _place(ind, std::move(priorities[count]), slots[count]);
+            if (ind && priorities[ind] < priorities[(ind - 1) / 2]) {
+                _heapify(ind);
+            } else {
+                _sift_down(ind);
+            }
+        }
+    }
+
+    constexpr void _place(size_t ind, K priority, uint32_t slot) noexcept {
+        /// запись элемента на место ind кучи
+        priorities[ind] = std::move(priority);
+        slots[ind] = slot;
+        positions[slot] = static_cast<uint32_t>(ind);
+    }
+
+    constexpr void _heapify(size_t ind) noexcept {
+        /// просеивание вверх
+        auto priority = std::move(priorities[ind]);
+        auto slot = slots[ind];
+        while (ind) {
+            auto parent = (ind - 1) / 2;
+            if (!(priority < priorities[parent])) {
+                break;
+            }
+            _place(ind, std::move(priorities[parent]), slots[parent]);
+            ind = parent;
+        }
+        _place(ind, std::move(priority), slot);
+    }
+
+    constexpr void _sift_down(size_t ind) noexcept {
+        /// просеивание вниз
+        auto priority = std::move(priorities[ind]);
+        auto slot = slots[ind];
+        for (auto child = 2 * ind + 1; child < count; child = 2 * ind + 1) {
+            if (child + 1 < count && priorities[child + 1] < priorities[child]) {
+                ++child;
+            }
+            if (!(priorities[child] < priority)) {
+                break;
+            }
+            _place(ind, std::move(priorities[child]), slots[child]);
+            ind = child;
+        }
+        _place(ind, std::move(priority), slot);
+    }
+};
+
+
+#endif //MINHEAP_FIXED_MINHEAP_HPP
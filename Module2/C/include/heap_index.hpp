@@ -0,0 +1,237 @@
+#ifndef MINHEAP_HEAP_INDEX_HPP
+#define MINHEAP_HEAP_INDEX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+template<class K, class T = uint32_t, class Hash = std::hash<K>>
+class FlatIndex {
+    /// хеш-таблица с открытой адресацией (линейное пробирование) для индекса кучи: ключи и значения лежат
+    /// в одном массиве ячеек без отдельных узлов, поиск обычно читает одну-две соседние ячейки
+    /// размер таблицы - степень двойки, заполнение не больше половины; хеш перемешивается умножением
+    /// (std::hash для целых - тождественная функция), пустая ячейка отмечается значением Empty
+    /// при удалении следующие ячейки цепочки сдвигаются назад, поэтому удаленных ячеек-надгробий нет
+    static_assert(std::is_unsigned_v<T>, "Values of flat index must be unsigned numbers");
+
+public:
+    static constexpr T Empty = std::numeric_limits<T>::max();
+
+    T *find(const K &key) noexcept {
+        /// метод поиска значения по ключу
+        /// если ключа нет, будет возвращен nullptr
+        auto ind = _find(key);
+        return ind == cells.size() ? nullptr : &cells[ind].value;
+    }
+
+    const T *find(const K &key) const noexcept {
+        auto ind = _find(key);
+        return ind == cells.size() ? nullptr : &cells[ind].value;
+    }
+
+    bool emplace(const K &key, T value) {
+        /// метод добавления пары ключ-значение
+        /// возвращает false, если ключ уже есть (значение при этом не меняется)
+        if (value == Empty) {
+            throw std::out_of_range{"Value is reserved for empty cells"};
+        }
+        if (2 * (count + 1) > cells.size()) {
+            _rehash(cells.empty() ? 16 : 2 * cells.size());
+        }
+        auto ind = _home(key);
+        for (; cells[ind].value != Empty; ind = (ind + 1) & mask) {
+            if (cells[ind].key == key) {
+                return false;
+            }
+        }
+        cells[ind].key = key;
+        cells[ind].value = value;
+        ++count;
+        return true;
+    }
+
+    bool erase(const K &key) noexcept {
+        /// метод удаления ключа
+        /// возвращает false, если ключа нет
+        auto hole = _find(key);
+        if (hole == cells.size()) {
+            return false;
+        }
+        for (auto ind = (hole + 1) & mask; cells[ind].value != Empty; ind = (ind + 1) & mask) {
+            /// ячейка переносится в дыру, если дыра лежит между ее домашней ячейкой и ею самой
+            if (((ind - _home(cells[ind].key)) & mask) >= ((ind - hole) & mask)) {
+                cells[hole] = std::move(cells[ind]);
+                hole = ind;
+            }
+        }
+        cells[hole].key = K();
+        cells[hole].value = Empty;
+        --count;
+        return true;
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        return count;
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        return !count;
+    }
+
+private:
+    struct Cell {
+        K key{};
+        T value = Empty;
+    };
+
+    std::vector<Cell> cells;
+    size_t count = 0;
+    size_t mask = 0;
+    unsigned shift = 64;
+
+    [[nodiscard]] size_t _home(const K &key) const noexcept {
+        /// домашняя ячейка ключа: старшие биты произведения хеша на 2^64 / phi
+        return static_cast<size_t>((static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    [[nodiscard]] size_t _find(const K &key) const noexcept {
+        /// индекс ячейки с ключом или cells.size(), если ключа нет
+        if (!count) {
+            return cells.size();
+        }
+        for (auto ind = _home(key); cells[ind].value != Empty; ind = (ind + 1) & mask) {
+            if (cells[ind].key == key) {
+                return ind;
+            }
+        }
+        return cells.size();
+    }
+
+    void _rehash(size_t capacity) {
+        /// перенос ячеек в таблицу размера capacity (степень двойки)
+        std::vector<Cell> old(capacity);
+        old.swap(cells);
+        mask = capacity - 1;
+        shift = 64;
+        for (; capacity > 1; capacity /= 2) {
+            --shift;
+        }
+        for (auto &cell: old) {
+            if (cell.value != Empty) {
+                auto ind = _home(cell.key);
+                while (cells[ind].value != Empty) {
+                    ind = (ind + 1) & mask;
+                }
+                cells[ind] = std::move(cell);
+            }
+        }
+    }
+};
+
+template<class K, class T = uint32_t>
+class DenseIndex {
+    /// индекс для плотных неотрицательных целых ключей: значение ключа k лежит в ячейке k вектора,
+    /// поиск - одно обращение к памяти без хеширования; память пропорциональна наибольшему ключу
+    /// отсутствие ключа отмечается значением Empty
+    static_assert(std::is_integral_v<K>, "Keys of dense index must be integers");
+    static_assert(std::is_unsigned_v<T>, "Values of dense index must be unsigned numbers");
+
+public:
+    static constexpr T Empty = std::numeric_limits<T>::max();
+
+    T *find(const K &key) noexcept {
+        /// метод поиска значения по ключу
+        /// если ключа нет, будет возвращен nullptr
+        return _contains(key) ? &table[static_cast<size_t>(key)] : nullptr;
+    }
+
+    const T *find(const K &key) const noexcept {
+        return _contains(key) ? &table[static_cast<size_t>(key)] : nullptr;
+    }
+
+    bool emplace(const K &key, T value) {
+        /// метод добавления пары ключ-значение
+        /// возвращает false, если ключ уже есть; для отрицательного ключа будет вызвано исключение
+        if (_negative(key)) {
+            throw std::out_of_range{"Key is out of dense index"};
+        }
+        if (value == Empty) {
+            throw std::out_of_range{"Value is reserved for empty cells"};
+        }
+        auto ind = static_cast<size_t>(key);
+        if (ind >= table.size()) {
+            table.resize(std::max(ind + 1, 2 * table.size()), Empty);
+        }
+        if (table[ind] != Empty) {
+            return false;
+        }
+        table[ind] = value;
+        ++count;
+        return true;
+    }
+
+    bool erase(const K &key) noexcept {
+        /// метод удаления ключа
+        /// возвращает false, если ключа нет
+        if (!_contains(key)) {
+            return false;
+        }
+        table[static_cast<size_t>(key)] = Empty;
+        --count;
+        return true;
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        return count;
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        return !count;
+    }
+
+private:
+    std::vector<T> table;
+    size_t count = 0;
+
+    [[nodiscard]] static bool _negative(const K &key) noexcept {
+        if constexpr (std::is_signed_v<K>) {
+            return key < 0;
+        } else {
+            return false;
+        }
+    }
+
+    [[nodiscard]] bool _contains(const K &key) const noexcept {
+        return !_negative(key) && static_cast<size_t>(key) < table.size() && table[static_cast<size_t>(key)] != Empty;
+    }
+};
+
+template<class K, class T = uint32_t>
+struct NoIndex {
+    /// пустой индекс для кучи, с которой работают только через дескрипторы: ключи не хранятся и не хешируются,
+    /// поэтому повторные ключи не обнаруживаются, а операции по ключу (index, remove, update_priority) их не находят
+    T *find(const K &) noexcept {
+        return nullptr;
+    }
+
+    const T *find(const K &) const noexcept {
+        return nullptr;
+    }
+
+    bool emplace(const K &, T) noexcept {
+        return true;
+    }
+
+    bool erase(const K &) noexcept {
+        return true;
+    }
+};
+
+
+#endif //MINHEAP_HEAP_INDEX_HPP
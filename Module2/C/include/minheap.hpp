@@ -2,203 +2,476 @@
 #define MINHEAP_MINHEAP_HPP
 
 #include <algorithm>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <tuple>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "cache_aligned_allocator.hpp"
+#include "heap_index.hpp"
 
-template<class K = int64_t, class V = std::string>
+
+template<class K, class V>
+struct HeapNode {
+    /// узел кучи: ключ (идентификатор элемента), значение и приоритет, по которому упорядочена куча
+    /// если приоритет не задан, он равен ключу
+    K key;
+    V value;
+    K priority;
+
+    explicit constexpr HeapNode(K k = K(), V v = V()) noexcept: key(k), value(std::move(v)), priority(std::move(k)) {}
+
+    constexpr HeapNode(K k, V v, K p) noexcept: key(std::move(k)), value(std::move(v)), priority(std::move(p)) {}
+
+    [[nodiscard]] std::string to_string() const noexcept {
+        /// метод преобразования узла в строку с возможностью указать индекс
+        return std::to_string(key) + ' ' + static_cast<std::string>(value);
+    }
+};
+
+
+template<class K = int64_t, class V = std::string, size_t Arity = 2, class Index = FlatIndex<K, uint32_t>>
 class MinHeap {
+    /// Arity-арная куча: дети узла i лежат подряд на местах Arity * i + 1 .. Arity * i + Arity, массив выделяется
+    /// так, что эта группа начинается с границы кэш-линии; при большей арности куча ниже, а просмотр детей на
+    /// каждом уровне идет по одной-двум соседним линиям
+    /// хранение разделено: в порядке кучи лежат только приоритеты и номера ячеек (slots), а ключи и значения
+    /// записываются в ячейки один раз при добавлении и больше не перемещаются; просеивание переставляет
+    /// приоритеты и 4-байтовые номера и обновляет позицию ячейки в positions, не трогая index_table
+    /// Index - индекс ключ -> ячейка: по умолчанию плоская хеш-таблица FlatIndex, для плотных неотрицательных
+    /// целых ключей - DenseIndex (прямая адресация по ключу), для работы только через дескрипторы - NoIndex
+    static_assert(Arity >= 2, "Arity of heap must be at least 2");
+
 public:
-    struct Node {
-        K key;
-        V value;
+    using Node = HeapNode<K, V>;
+
+    struct NodeRef {
+        /// ссылка на узел кучи по индексу: ключ и значение лежат в ячейке, приоритет - в массиве кучи
+        K &key;
+        V &value;
+        K &priority;
 
-        explicit Node(K k = K(), V v = V()) noexcept: key(k), value(v) {}
+        operator Node() const {
+            return Node(key, value, priority);
+        }
 
-        [[nodiscard]] std::string to_string() const noexcept {
-            /// метод преобразования узла в строку с возможностью указать индекс
-            return std::to_string(key) + ' ' + static_cast<std::string>(value);
+        const NodeRef &operator=(const Node &node) const {
+            /// запись узла целиком (index_table при этом не меняется)
+            key = node.key;
+            value = node.value;
+            priority = node.priority;
+            return *this;
         }
     };
 
-    void add(const K &key, const V &value) {
+    struct Handle {
+        /// дескриптор элемента: номер его ячейки и поколение ячейки на момент добавления
+        /// ячейка не меняется, пока элемент в куче, поэтому операции по дескриптору не ищут ключ в индексе;
+        /// при освобождении ячейки поколение увеличивается, и старые дескрипторы становятся недействительными
+        uint32_t slot;
+        uint32_t generation;
+    };
+
+    Handle add(const K &key, const V &value) {
         /// метод добавления пары ключ-значение
+        /// возвращает дескриптор элемента
         /// если ключ уже добавлен в кучу, будет вызвано исключение
-        if (index_table.count(key) != 0) {
-            throw std::logic_error{"This key have already added"};
+        return add(key, value, key);
+    }
+
+    Handle add(const K &key, const V &value, const K &priority) {
+        /// метод добавления пары ключ-значение с отдельным приоритетом
+        /// возвращает дескриптор элемента
+        /// если ключ уже добавлен в кучу, будет вызвано исключение
+        auto slot = _append(key, value, priority);
+        _heapify(slots.size() - 1);
+        return Handle{slot, generations[slot]};
+    }
+
+    template<class It>
+    void build(It first, It last) {
+        /// метод построения кучи из диапазона узлов за O(n) (алгоритм Флойда): узлы дописываются в массив
+        /// вместе с заполнением index_table, затем просеиваются вниз все внутренние узлы снизу вверх
+        /// прежнее содержимое кучи заменяется; если ключи повторяются, будет вызвано исключение,
+        /// а куча останется прежней
+        MinHeap heap;
+        for (; first != last; ++first) {
+            const Node &node = *first;
+            heap._append(node.key, node.value, node.priority);
+        }
+        heap._rebuild();
+        *this = std::move(heap);
+    }
+
+    template<class It>
+    void add_batch(It first, It last) {
+        /// метод добавления диапазона узлов: узлы дописываются в конец массива, затем либо каждый поднимается
+        /// просеиванием, либо, если пачка велика по сравнению с кучей (k * log(n) > n), куча перестраивается
+        /// целиком за O(n)
+        /// если ключ уже есть в куче или повторяется в пачке, будет вызвано исключение, а куча останется прежней
+        auto old_size = slots.size();
+        try {
+            for (; first != last; ++first) {
+                const Node &node = *first;
+                _append(node.key, node.value, node.priority);
+            }
+        } catch (...) {
+            _truncate(old_size);
+            throw;
+        }
+        auto added = slots.size() - old_size;
+        size_t height = 0;
+        for (auto n = slots.size(); n > 1; n /= Arity) {
+            ++height;
+        }
+        if (added * height > slots.size()) {
+            _rebuild();
+        } else {
+            for (auto ind = old_size; ind < slots.size(); ++ind) {
+                _heapify(ind);
+            }
         }
-        tape.emplace_back(key, value);
-        index_table.emplace(key, tape.size() - 1);
-        _heapify(tape.size() - 1);
+    }
+
+    template<class Range>
+    void add_batch(const Range &range) {
+        /// метод добавления контейнера узлов (см. add_batch(first, last))
+        add_batch(std::begin(range), std::end(range));
+    }
+
+    void update_priority(const K &key, const K &new_priority) {
+        /// метод изменения приоритета элемента с ключом key (например, decrease-key в алгоритме Дейкстры)
+        /// элемент просеивается вверх или вниз от своего места, ключ и index_table остаются прежними
+        /// если ключа нет в куче, будет вызвано исключение
+        auto slot = index_table.find(key);
+        if (!slot) {
+            throw std::logic_error{"Cannot update priority of absent key"};
+        }
+        _update(*slot, new_priority);
+    }
+
+    void update(const Handle handle, const K &new_priority) {
+        /// метод изменения приоритета элемента по дескриптору (без поиска ключа)
+        /// если дескриптор недействителен, будет вызвано исключение
+        _update(_check(handle), new_priority);
+    }
+
+    V &value(const Handle handle) {
+        /// метод доступа к значению элемента по дескриптору
+        /// если дескриптор недействителен, будет вызвано исключение
+        return items[_check(handle)].value;
+    }
+
+    [[nodiscard]] bool contains(const Handle handle) const noexcept {
+        /// метод проверки, что элемент с дескриптором handle еще в куче
+        return handle.slot < items.size() && generations[handle.slot] == handle.generation;
     }
 
     size_t index(const K &key) const noexcept {
         /// метод получения индекса по ключу
         /// если ключа нет в куче, будет возвращено -1
-        auto node = index_table.find(key);
-        if (node == index_table.end()) {
+        auto slot = index_table.find(key);
+        if (!slot) {
+            return -1;
+        }
+        return positions[*slot];
+    }
+
+    size_t index(const Handle handle) const noexcept {
+        /// метод получения индекса по дескриптору
+        /// если дескриптор недействителен, будет возвращено -1
+        if (!contains(handle)) {
             return -1;
         }
-        return node->second;
+        return positions[handle.slot];
     }
 
-    Node &at(const size_t ind) {
+    NodeRef at(const size_t ind) {
         /// метод, осуществляющий доступ по индексу
         /// если индекса нет, будет вызвано исключение
-        if (ind >= tape.size()) {
+        if (ind >= slots.size()) {
             throw std::out_of_range{"Index is out of heap"};
         }
-        return tape[ind];
+        auto &item = items[slots[ind]];
+        return NodeRef{item.key, item.value, priorities[ind]};
     }
 
     Node extract() {
         /// метод извлечения корня кучи (удаление и возвращение функцией)
+        /// значение переносится из ячейки без копирования
         /// если куча пустая, будет вызвано исключение
         if (empty()) {
             throw std::logic_error{"Cannot extract from empty heap"};
         }
-        auto top = tape.front();
-        remove(top.key);
+        auto slot = slots.front();
+        auto &item = items[slot];
+        Node top(std::move(item.key), std::move(item.value), std::move(priorities.front()));
+        index_table.erase(top.key);
+        _release(slot);
+        _remove(0);
         return top;
     }
 
     void remove(const K &key) {
         /// метод удаления узла по ключу
         /// если ключа нет в куче, будет вызвано исключение
-        auto node = index_table.find(key);
-        if (node == index_table.end()) {
+        auto found = index_table.find(key);
+        if (!found) {
             throw std::logic_error{"Cannot remove from empty heap"};
         }
-        auto ind = node->second;
-        index_table[tape.back().key] = ind;
-        index_table.erase(node);
-        _remove(ind);
+        _erase(*found);
+    }
+
+    void remove(const Handle handle) {
+        /// метод удаления узла по дескриптору
+        /// если дескриптор недействителен, будет вызвано исключение
+        _erase(_check(handle));
     }
 
     [[nodiscard]] inline Node max() const {
         /// метод поиска максимума в куче
         /// возвращает макс. элемент
         /// если куча пустая, будет вызвано исключение
-        if (tape.empty()) {
+        auto ind = max_index();
+        auto &item = items[slots[ind]];
+        return Node(item.key, item.value, priorities[ind]);
+    }
+
+    [[nodiscard]] size_t max_index() const {
+        /// метод получения индекса максимума (просмотр приоритетов, максимум лежит в одном из листьев)
+        /// если куча пустая, будет вызвано исключение
+        if (priorities.empty()) {
             throw std::logic_error{"Cannot find max element in empty heap"};
         }
-        return tape[std::distance(tape.begin(),
-                                  std::max_element(tape.begin(), tape.end(), [](const Node &n1, const Node &n2) {
-                                      return n1.key < n2.key;
-                                  }))];
+        return std::distance(priorities.begin(),
+                             std::max_element(priorities.begin() + (priorities.size() - 1) / Arity,
+                                              priorities.end()));
     }
 
     [[nodiscard]] inline bool empty() const noexcept {
         /// метод проверки, пустая ли куча
         /// возвращает true, если пустая, false - иначе
-        return tape.empty();
+        return slots.empty();
     }
 
-    template<class Key, class Value>
-    friend std::ostream &operator<<(std::ostream &, const MinHeap<Key, Value> &) noexcept;
+    [[nodiscard]] inline size_t size() const noexcept {
+        /// метод получения числа элементов кучи
+        return slots.size();
+    }
+
+    template<class Key, class Value, size_t A, class I>
+    friend std::ostream &operator<<(std::ostream &, const MinHeap<Key, Value, A, I> &) noexcept;
 
 private:
-    std::vector<Node> tape;
-    std::unordered_map<K, size_t> index_table;  // ключ, индекс в tape
+    struct Item {
+        /// ячейка с ключом и значением, ее место не меняется, пока элемент в куче
+        K key;
+        V value;
+    };
+
+    template<class T>
+    using HeapArray = std::vector<T, CacheAlignedAllocator<T, Arity - 1>>;
+
+    HeapArray<K> priorities;            // приоритеты в порядке кучи
+    HeapArray<uint32_t> slots;          // номера ячеек в порядке кучи
+    std::deque<Item> items;             // ячейки (deque не перемещает элементы при росте)
+    std::vector<size_t> positions;      // номер ячейки, индекс в куче
+    std::vector<uint32_t> free_slots;   // освобожденные ячейки
+    std::vector<uint32_t> generations;  // номер ячейки, поколение (для проверки дескрипторов)
+    Index index_table;                  // ключ, номер ячейки (индекс в куче - positions[ячейка])
 
     [[nodiscard]] static inline size_t _left(size_t i) noexcept {
-        /// статический метод получения индекса левого ребенка
-        return 2 * i + 1;
+        /// статический метод получения индекса левого (первого) ребенка
+        return Arity * i + 1;
     }
 
     [[nodiscard]] static inline size_t _parent(size_t i) noexcept {
         /// статический метод получения индекса родителя
-        return (i - 1) / 2;
+        return (i - 1) / Arity;
     }
 
-    void _heapify(size_t ind) noexcept {
-        /// метод heapify для перестройки кучи
-        if (!ind) {
-            return;
+    uint32_t _append(const K &key, const V &value, const K &priority) {
+        /// запись пары в свободную ячейку и в конец массива кучи без просеивания
+        /// если ключ уже есть, будет вызвано исключение
+        if (index_table.find(key)) {
+            throw std::logic_error{"This key have already added"};
+        }
+        auto slot = _allocate(key, value);
+        index_table.emplace(key, slot);
+        priorities.push_back(priority);
+        slots.push_back(slot);
+        positions[slot] = slots.size() - 1;
+        return slot;
+    }
+
+    void _truncate(size_t size) {
+        /// отмена добавлений: удаление элементов массива кучи с индекса size (без просеивания)
+        while (slots.size() > size) {
+            auto slot = slots.back();
+            index_table.erase(items[slot].key);
+            items[slot] = Item();
+            _release(slot);
+            priorities.pop_back();
+            slots.pop_back();
+        }
+    }
+
+    void _rebuild() noexcept {
+        /// построение кучи Флойда: просеивание вниз внутренних узлов от последнего к корню
+        for (auto ind = slots.size() / Arity + 1; ind--;) {
+            if (_left(ind) < slots.size()) {
+                _sift_down(ind);
+            }
+        }
+    }
+
+    uint32_t _allocate(const K &key, const V &value) {
+        /// выделение ячейки под пару: сначала переиспользуются освобожденные
+        if (!free_slots.empty()) {
+            auto slot = free_slots.back();
+            free_slots.pop_back();
+            items[slot] = Item{key, value};
+            return slot;
+        }
+        if (items.size() == std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error{"Too many elements in heap"};
+        }
+        items.push_back(Item{key, value});
+        positions.push_back(0);
+        generations.push_back(0);
+        return static_cast<uint32_t>(items.size() - 1);
+    }
+
+    void _release(uint32_t slot) {
+        /// возврат ячейки в список свободных, дескрипторы ячейки становятся недействительными
+        ++generations[slot];
+        free_slots.push_back(slot);
+    }
+
+    uint32_t _check(const Handle handle) const {
+        /// проверка дескриптора, возвращает номер ячейки
+        if (!contains(handle)) {
+            throw std::logic_error{"Invalid handle"};
         }
-        auto parent = _parent(ind);
-        while (ind && tape[ind].key < tape[parent].key) {
-            std::swap(index_table.at(tape[ind].key), index_table.at(tape[parent].key));
-            std::swap(tape[ind], tape[parent]);
+        return handle.slot;
+    }
+
+    void _update(uint32_t slot, const K &new_priority) noexcept {
+        /// изменение приоритета элемента в ячейке slot с просеиванием вверх или вниз
+        auto ind = positions[slot];
+        auto increased = priorities[ind] < new_priority;
+        priorities[ind] = new_priority;
+        if (increased) {
+            _sift_down(ind);
+        } else {
+            _heapify(ind);
+        }
+    }
+
+    void _erase(uint32_t slot) {
+        /// удаление элемента в ячейке slot
+        index_table.erase(items[slot].key);
+        items[slot] = Item();
+        _release(slot);
+        _remove(positions[slot]);
+    }
+
+    void _place(size_t ind, K priority, uint32_t slot) noexcept {
+        /// запись элемента на место ind кучи
+        priorities[ind] = std::move(priority);
+        slots[ind] = slot;
+        positions[slot] = ind;
+    }
+
+    void _heapify(size_t ind) noexcept {
+        /// метод heapify для перестройки кучи (просеивание вверх)
+        /// элемент не переставляется на каждом шаге: родители сдвигаются вниз, и он записывается один раз
+        auto priority = std::move(priorities[ind]);
+        auto slot = slots[ind];
+        while (ind) {
+            auto parent = _parent(ind);
+            if (!(priority < priorities[parent])) {
+                break;
+            }
+            _place(ind, std::move(priorities[parent]), slots[parent]);
             ind = parent;
-            parent = _parent(parent);
         }
+        _place(ind, std::move(priority), slot);
     }
 
     void _remove(size_t ind) noexcept {
-        /// метод удаления по индексу
-        std::swap(tape[ind], tape.back());
-        tape.pop_back();
-        size_t parent;
-        if (ind != tape.size() - 1) {
-            parent = _parent(ind);
-            if (!ind || tape[parent].key < tape[ind].key) {
-                auto left = _left(ind);
-                auto right = left + 1;
-                while (left < tape.size()) {
-                    if (right < tape.size()) {
-                        if (tape[ind].key < tape[left].key && tape[ind].key < tape[right].key) {
-                            break;
-                        }
-                        if (tape[left].key < tape[right].key) {
-                            std::swap(index_table.at(tape[ind].key), index_table.at(tape[left].key));
-                            std::swap(tape[left], tape[ind]);
-                            ind = left;
-                        } else {
-                            std::swap(index_table.at(tape[ind].key), index_table.at(tape[right].key));
-                            std::swap(tape[right], tape[ind]);
-                            ind = right;
-                        }
-                    } else {
-                        if (tape[ind].key < tape[left].key) {
-                            break;
-                        }
-                        std::swap(index_table.at(tape[ind].key), index_table.at(tape[left].key));
-                        std::swap(tape[left], tape[ind]);
-                        ind = left;
-                    }
-                    left = _left(ind);
-                    right = left + 1;
+        /// метод удаления по индексу: на место ind встает последний элемент и просеивается
+        auto last = slots.size() - 1;
+        if (ind != last) {
+            _place(ind, std::move(priorities[last]), slots[last]);
+        }
+        priorities.pop_back();
+        slots.pop_back();
+        if (ind < slots.size()) {
+            if (ind && priorities[ind] < priorities[_parent(ind)]) {
+                _heapify(ind);
+            } else {
+                _sift_down(ind);
+            }
+        }
+    }
+
+    void _sift_down(size_t ind) noexcept {
+        /// метод просеивания узла вниз: на место узла поднимается минимальный ребенок, пока тот меньше узла
+        /// минимальный ребенок ищется только по приоритетам, лежащим подряд
+        auto priority = std::move(priorities[ind]);
+        auto slot = slots[ind];
+        for (auto first = _left(ind); first < slots.size(); first = _left(ind)) {
+            auto last = std::min(first + Arity, slots.size());
+            auto child = first;
+            for (auto i = first + 1; i < last; ++i) {
+                if (priorities[i] < priorities[child]) {
+                    child = i;
                 }
-                return;
             }
-            _heapify(ind);
+            if (!(priorities[child] < priority)) {
+                break;
+            }
+            _place(ind, std::move(priorities[child]), slots[child]);
+            ind = child;
         }
+        _place(ind, std::move(priority), slot);
     }
 };
 
-template<class Key, class Value>
-std::ostream &operator<<(std::ostream &out, const MinHeap<Key, Value> &heap) noexcept {
+template<class Key, class Value, size_t Arity, class Index>
+std::ostream &operator<<(std::ostream &out, const MinHeap<Key, Value, Arity, Index> &heap) noexcept {
     /// оператор печати кучи в соответствии с заданными требованиями
     if (heap.empty()) {
         return out << '_';
     }
-    auto empty_nodes = [](size_t n) {
-        std::string res;
-        if (n) {
-            res.reserve(2 * n);
-            for (; n; --n) {
-                res += " _";
-            }
-        }
-        return res;
+    auto item = [&heap](size_t i) -> auto & {
+        return heap.items[heap.slots[i]];
     };
-    out << "[" << heap.tape[0].to_string() << "]";
+    out << "[" << item(0).key << ' ' << item(0).value << "]";
+    size_t layer_start = 0;
     size_t layer_size = 1;
-    for (size_t i = 1; i < heap.tape.size(); ++i) {
-        if (i == 2 * layer_size - 1) {
+    for (size_t i = 1; i < heap.size(); ++i) {
+        if (i == layer_start + layer_size) {
             out << '\n';
-            layer_size *= 2;
+            layer_start = i;
+            layer_size *= Arity;
         } else {
             out << ' ';
         }
-        out << '[' << heap.tape[i].to_string() << ' ' << heap.tape[(i - 1) / 2].key << ']';
+        out << '[' << item(i).key << ' ' << item(i).value << ' ' << item((i - 1) / Arity).key << ']';
+    }
+    for (auto n = layer_start + layer_size - heap.size(); n; --n) {
+        out << " _";
     }
-    return out << empty_nodes(2 * layer_size - heap.tape.size() - 1);
+    return out;
 }
 
 
@@ -212,9 +485,10 @@ void parser(const std::string &command, std::string &name, std::string &key, std
     stream >> name >> key >> value >> dump;
 }
 
-template<class I, class O>
+template<class I, class O, class Heap = MinHeap<>>
 void handler(I &stream_in, O &stream_out) {
-    MinHeap<> mhp;
+    /// функция обработки команд, Heap - реализация кучи (MinHeap или MinMaxHeap)
+    Heap mhp;
 
     std::string command;
     std::string name;
@@ -223,7 +497,7 @@ void handler(I &stream_in, O &stream_out) {
     std::string dump;
 
     size_t index;
-    MinHeap<>::Node get_node_res;
+    typename Heap::Node get_node_res;
 
     while (getline(stream_in, command)) {
         if (command.empty()) {
@@ -240,9 +514,9 @@ void handler(I &stream_in, O &stream_out) {
                 }
             } else if (name == "max") {
                 try {
-                    get_node_res = mhp.max();
-                    stream_out << get_node_res.key << ' ' << mhp.index(get_node_res.key) << ' ' << get_node_res.value
-                               << '\n';
+                    index = mhp.max_index();
+                    get_node_res = mhp.at(index);
+                    stream_out << get_node_res.key << ' ' << index << ' ' << get_node_res.value << '\n';
                 } catch (std::logic_error &) {
                     stream_out << "error\n";
                 }
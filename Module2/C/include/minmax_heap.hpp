@@ -0,0 +1,261 @@
+#ifndef MINHEAP_MINMAX_HEAP_HPP
+#define MINHEAP_MINMAX_HEAP_HPP
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "minheap.hpp"
+
+
+template<class K = int64_t, class V = std::string>
+class MinMaxHeap {
+    /// min-max куча: на четных уровнях (корень - уровень 0) узел не больше всех потомков, на нечетных - не меньше
+    /// минимум лежит в корне, максимум - в одном из его детей, поэтому оба находятся за O(1), а извлечение
+    /// минимума или максимума выполняется за O(log n)
+    /// как и в MinHeap, index_table хранит индекс каждого ключа в tape
+public:
+    using Node = HeapNode<K, V>;
+
+    void add(const K &key, const V &value) {
+        /// метод добавления пары ключ-значение
+        /// если ключ уже добавлен в кучу, будет вызвано исключение
+        if (index_table.count(key) != 0) {
+            throw std::logic_error{"This key have already added"};
+        }
+        tape.emplace_back(key, value);
+        index_table.emplace(key, tape.size() - 1);
+        _restore(tape.size() - 1);
+    }
+
+    size_t index(const K &key) const noexcept {
+        /// метод получения индекса по ключу
+        /// если ключа нет в куче, будет возвращено -1
+        auto node = index_table.find(key);
+        if (node == index_table.end()) {
+            return -1;
+        }
+        return node->second;
+    }
+
+    Node &at(const size_t ind) {
+        /// метод, осуществляющий доступ по индексу
+        /// если индекса нет, будет вызвано исключение
+        if (ind >= tape.size()) {
+            throw std::out_of_range{"Index is out of heap"};
+        }
+        return tape[ind];
+    }
+
+    const Node &min() const {
+        /// метод получения минимума за O(1)
+        /// если куча пустая, будет вызвано исключение
+        if (tape.empty()) {
+            throw std::logic_error{"Cannot find min element in empty heap"};
+        }
+        return tape.front();
+    }
+
+    const Node &max() const {
+        /// метод получения максимума за O(1)
+        /// если куча пустая, будет вызвано исключение
+        return tape[max_index()];
+    }
+
+    [[nodiscard]] size_t max_index() const {
+        /// метод получения индекса максимума: корень или больший из его детей
+        /// если куча пустая, будет вызвано исключение
+        if (tape.empty()) {
+            throw std::logic_error{"Cannot find max element in empty heap"};
+        }
+        if (tape.size() < 3) {
+            return tape.size() - 1;
+        }
+        return tape[1].key < tape[2].key ? 2 : 1;
+    }
+
+    Node extract() {
+        /// метод извлечения минимума (как в MinHeap)
+        return extract_min();
+    }
+
+    Node extract_min() {
+        /// метод извлечения минимума
+        /// если куча пустая, будет вызвано исключение
+        if (empty()) {
+            throw std::logic_error{"Cannot extract from empty heap"};
+        }
+        return _extract(0);
+    }
+
+    Node extract_max() {
+        /// метод извлечения максимума
+        /// если куча пустая, будет вызвано исключение
+        if (empty()) {
+            throw std::logic_error{"Cannot extract from empty heap"};
+        }
+        return _extract(max_index());
+    }
+
+    void remove(const K &key) {
+        /// метод удаления узла по ключу
+        /// если ключа нет в куче, будет вызвано исключение
+        auto node = index_table.find(key);
+        if (node == index_table.end()) {
+            throw std::logic_error{"Cannot remove from empty heap"};
+        }
+        auto ind = node->second;
+        index_table[tape.back().key] = ind;
+        index_table.erase(node);
+        _remove(ind);
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        /// метод проверки, пустая ли куча
+        return tape.empty();
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        /// метод получения числа элементов кучи
+        return tape.size();
+    }
+
+    template<class Key, class Value>
+    friend std::ostream &operator<<(std::ostream &, const MinMaxHeap<Key, Value> &) noexcept;
+
+private:
+    std::vector<Node> tape;
+    std::unordered_map<K, size_t> index_table;  // ключ, индекс в tape
+
+    [[nodiscard]] static inline size_t _parent(size_t i) noexcept {
+        /// статический метод получения индекса родителя
+        return (i - 1) / 2;
+    }
+
+    [[nodiscard]] static inline bool _min_level(size_t i) noexcept {
+        /// статический метод проверки, лежит ли индекс на уровне минимумов (четном)
+        return (63 - __builtin_clzll(static_cast<unsigned long long>(i) + 1)) % 2 == 0;
+    }
+
+    [[nodiscard]] static inline bool _before(const Node &a, const Node &b, bool min_level) noexcept {
+        /// порядок уровня: на уровне минимумов меньший ключ ближе к корню, на уровне максимумов - больший
+        return min_level ? a.key < b.key : b.key < a.key;
+    }
+
+    void _swap(size_t i, size_t j) noexcept {
+        /// обмен узлов с обновлением индексов
+        std::swap(index_table.at(tape[i].key), index_table.at(tape[j].key));
+        std::swap(tape[i], tape[j]);
+    }
+
+    Node _extract(size_t ind) {
+        /// извлечение узла по индексу
+        auto top = tape[ind];
+        index_table[tape.back().key] = ind;
+        index_table.erase(top.key);
+        _remove(ind);
+        return top;
+    }
+
+    void _remove(size_t ind) noexcept {
+        /// метод удаления по индексу: на место узла встает последний, затем он поднимается или опускается
+        std::swap(tape[ind], tape.back());
+        tape.pop_back();
+        if (ind < tape.size()) {
+            _restore(ind);
+        }
+    }
+
+    void _restore(size_t ind) noexcept {
+        /// восстановление свойств кучи для узла, который мог нарушить их и с предками, и с потомками
+        /// если узел нарушает порядок с родителем (уровнем другого типа), они меняются местами: бывший родитель
+        /// опускается, а узел поднимается по уровням родителя; иначе узел поднимается по своим уровням
+        /// и, если остался на месте, опускается
+        auto min_level = _min_level(ind);
+        if (ind) {
+            auto parent = _parent(ind);
+            if (_before(tape[parent], tape[ind], min_level)) {
+                _swap(ind, parent);
+                _push_up(parent, !min_level);
+                _push_down(ind, min_level);
+                return;
+            }
+        }
+        if (_push_up(ind, min_level) == ind) {
+            _push_down(ind, min_level);
+        }
+    }
+
+    size_t _push_up(size_t ind, bool min_level) noexcept {
+        /// подъем узла по уровням одного типа (через деда)
+        /// возвращает итоговый индекс узла
+        while (ind > 2) {
+            auto grandparent = _parent(_parent(ind));
+            if (!_before(tape[ind], tape[grandparent], min_level)) {
+                break;
+            }
+            _swap(ind, grandparent);
+            ind = grandparent;
+        }
+        return ind;
+    }
+
+    void _push_down(size_t ind, bool min_level) noexcept {
+        /// спуск узла: среди детей и внуков выбирается крайний для уровня (минимальный или максимальный)
+        /// если это внук, узел меняется с ним местами и при необходимости с новым родителем, спуск продолжается
+        for (;;) {
+            auto first_child = 2 * ind + 1;
+            if (first_child >= tape.size()) {
+                return;
+            }
+            auto best = first_child;
+            auto last = std::min(4 * ind + 7, tape.size());  // дети 2i+1, 2i+2 и внуки 4i+3 .. 4i+6
+            for (auto i: {first_child + 1, 4 * ind + 3, 4 * ind + 4, 4 * ind + 5, 4 * ind + 6}) {
+                if (i < last && _before(tape[i], tape[best], min_level)) {
+                    best = i;
+                }
+            }
+            if (!_before(tape[best], tape[ind], min_level)) {
+                return;
+            }
+            _swap(ind, best);
+            if (best <= first_child + 1) {
+                return;
+            }
+            auto parent = _parent(best);
+            if (_before(tape[parent], tape[best], min_level)) {
+                _swap(best, parent);
+            }
+            ind = best;
+        }
+    }
+};
+
+template<class Key, class Value>
+std::ostream &operator<<(std::ostream &out, const MinMaxHeap<Key, Value> &heap) noexcept {
+    /// оператор печати кучи в формате MinHeap
+    if (heap.empty()) {
+        return out << '_';
+    }
+    out << "[" << heap.tape[0].to_string() << "]";
+    size_t layer_size = 1;
+    for (size_t i = 1; i < heap.tape.size(); ++i) {
+        if (i == 2 * layer_size - 1) {
+            out << '\n';
+            layer_size *= 2;
+        } else {
+            out << ' ';
+        }
+        out << '[' << heap.tape[i].to_string() << ' ' << heap.tape[(i - 1) / 2].key << ']';
+    }
+    for (auto n = 2 * layer_size - heap.tape.size() - 1; n; --n) {
+        out << " _";
+    }
+    return out;
+}
+
+
+#endif //MINHEAP_MINMAX_HEAP_HPP
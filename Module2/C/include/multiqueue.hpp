@@ -0,0 +1,173 @@
+#ifndef MINHEAP_MULTIQUEUE_HPP
+#define MINHEAP_MULTIQUEUE_HPP
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "heap_index.hpp"
+#include "minheap.hpp"
+
+
+template<class K = int64_t, class V = std::string, size_t Arity = 2>
+class MultiQueue {
+    /// ослабленная конкурентная очередь с приоритетами из нескольких MinHeap (шардов), у каждого своя блокировка
+    /// добавление идет в случайный шард; при извлечении выбираются два случайных шарда, и из того, у которого
+    /// меньше минимальный приоритет, извлекается корень; занятый другим потоком шард не ждут, а выбирают заново,
+    /// и только после 2 * (число шардов) неудачных попыток ожидают блокировки
+    /// извлекается не обязательно глобальный минимум, но элемент с небольшим рангом (при c * P шардах средний
+    /// ранг ошибки - O(c * P)); минимум и размер каждого шарда дублируются в атомарных полях, поэтому выбор
+    /// шарда не берет блокировок
+    /// ключи не индексируются (шарды - MinHeap с NoIndex) и могут повторяться
+    static_assert(std::is_trivially_copyable_v<K>, "Priorities of multiqueue must be trivially copyable");
+
+public:
+    using Node = HeapNode<K, V>;
+
+    explicit MultiQueue(size_t threads, size_t factor = 2) {
+        /// очередь из factor * threads шардов
+        /// если число потоков или множитель нулевые, будет вызвано исключение
+        if (!threads || !factor) {
+            throw std::logic_error{"Multiqueue needs at least one shard"};
+        }
+        shards = std::vector<Shard>(threads * factor);
+    }
+
+    void add(const K &key, const V &value) {
+        /// метод добавления пары ключ-значение с приоритетом, равным ключу
+        add(key, value, key);
+    }
+
+    void add(const K &key, const V &value, const K &priority) {
+        /// метод добавления пары ключ-значение в случайный свободный шард
+        auto &generator = _generator();
+        for (size_t attempt = 0; attempt < 2 * shards.size(); ++attempt) {
+            auto &shard = shards[generator() % shards.size()];
+            std::unique_lock<std::mutex> lock(shard.lock, std::try_to_lock);
+            if (lock) {
+                _push(shard, key, value, priority);
+                return;
+            }
+        }
+        auto &shard = shards[generator() % shards.size()];
+        std::lock_guard<std::mutex> lock(shard.lock);
+        _push(shard, key, value, priority);
+    }
+
+    bool try_extract(Node &node) {
+        /// метод извлечения элемента с малым приоритетом в node
+        /// возвращает false, если все шарды пусты
+        auto &generator = _generator();
+        for (size_t attempt = 0; attempt < 2 * shards.size(); ++attempt) {
+            auto &first = shards[generator() % shards.size()];
+            auto &second = shards[generator() % shards.size()];
+            auto &shard = second.before(first) ? second : first;
+            if (!shard.size.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(shard.lock, std::try_to_lock);
+            if (lock && _pop(shard, node)) {
+                return true;
+            }
+        }
+        for (auto &shard: shards) {
+            // случайный выбор долго попадает в пустые или занятые шарды: обход всех с ожиданием блокировки
+            std::lock_guard<std::mutex> lock(shard.lock);
+            if (_pop(shard, node)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Node extract() {
+        /// метод извлечения элемента с малым приоритетом
+        /// если очередь пустая, будет вызвано исключение
+        Node node;
+        if (!try_extract(node)) {
+            throw std::logic_error{"Cannot extract from empty heap"};
+        }
+        return node;
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        /// метод проверки, пустая ли очередь (при одновременных изменениях - приблизительно)
+        return !size();
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        /// метод получения числа элементов (при одновременных изменениях - приблизительно)
+        /// общего счетчика нет, чтобы потоки не делили его кэш-линию: размеры шардов суммируются
+        size_t count = 0;
+        for (auto &shard: shards) {
+            count += shard.size.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    [[nodiscard]] inline size_t shard_count() const noexcept {
+        /// метод получения числа шардов
+        return shards.size();
+    }
+
+private:
+    struct alignas(64) Shard {
+        /// шард на отдельной кэш-линии, чтобы блокировки соседних шардов не делили линию
+        std::mutex lock;
+        MinHeap<K, V, Arity, NoIndex<K>> heap;
+        std::atomic<K> top{};           // приоритет корня heap
+        std::atomic<size_t> size{0};    // число элементов heap
+
+        void publish() noexcept {
+            /// обновление атомарных копий после изменения heap (под блокировкой)
+            if (!heap.empty()) {
+                top.store(heap.at(0).priority, std::memory_order_relaxed);
+            }
+            size.store(heap.size(), std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool before(const Shard &other) const noexcept {
+            /// сравнение шардов по минимуму без блокировок, пустой шард - последний
+            if (!size.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            return !other.size.load(std::memory_order_relaxed) ||
+                   top.load(std::memory_order_relaxed) < other.top.load(std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<Shard> shards;
+
+    void _push(Shard &shard, const K &key, const V &value, const K &priority) {
+        /// добавление элемента в шард (под блокировкой)
+        shard.heap.add(key, value, priority);
+        shard.publish();
+    }
+
+        bool _pop(Shard &shard, Node &node) {
+        /// извлечение корня шарда (под блокировкой), false - если шард пуст
+        if (shard.heap.empty()) {
+            return false;
+        }
+        node = shard.heap.extract();
+        shard.publish();
+        return true;
+    }
+
+    static std::mt19937 &_generator() {
+        /// генератор случайных номеров шардов, свой у каждого потока
+        thread_local std::mt19937 generator(
+                static_cast<std::mt19937::result_type>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+        return generator;
+    }
+};
+
+
+#endif //MINHEAP_MULTIQUEUE_HPP
@@ -0,0 +1,435 @@
+#ifndef MINHEAP_PAIRING_HEAP_HPP
+#define MINHEAP_PAIRING_HEAP_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "minheap.hpp"
+
+
+template<class K = int64_t, class V = std::string, bool Indexed = true>
+class PairingHeap {
+    /// pairing-куча: каждый элемент - отдельный узел дерева, дети узла связаны в список (первый ребенок,
+    /// следующий брат, предыдущий брат или родитель); корень - минимальный элемент
+    /// добавление, слияние куч (meld) и уменьшение приоритета - O(1): узел или куча подвешивается к корню;
+    /// извлечение и удаление - O(log n) амортизированно: дети корня сливаются попарно слева направо,
+    /// затем пары сливаются справа налево
+    /// узлы не перемещаются, поэтому дескриптор (Handle) действителен, пока элемент в куче; удаленные узлы
+    /// не освобождаются, а с увеличенным поколением уходят в список запасных и переиспользуются при добавлении,
+    /// поэтому устаревший дескриптор распознается, пока жива куча, из которой удален элемент
+    /// при Indexed = true поддерживается индекс ключ -> узел, и при слиянии ключи меньшей кучи проверяются
+    /// и вставляются в индекс большей: O(min(n, m)) в среднем, плюс амортизированный рост таблицы большей кучи,
+    /// как при обычных вставках; при Indexed = false ключи не хешируются вовсе, слияние - строго O(1),
+    /// а с элементами работают через дескрипторы
+    struct PairingNode {
+        K key;
+        V value;
+        K priority;
+        PairingNode *child = nullptr;
+        PairingNode *next = nullptr;
+        PairingNode *prev = nullptr;  // предыдущий брат, а у первого ребенка - родитель
+        uint32_t generation = 0;      // увеличивается при удалении узла из кучи
+
+        PairingNode(const K &k, const V &v, const K &p) : key(k), value(v), priority(p) {}
+    };
+
+    struct NoTable {
+    };
+
+public:
+    using Node = HeapNode<K, V>;
+
+    struct Handle {
+        /// дескриптор элемента: его узел и поколение узла на момент добавления
+        /// операции по дескриптору не ищут ключ в индексе; после удаления элемента поколение узла увеличивается,
+        /// и старые дескрипторы становятся недействительными
+        PairingNode *node;
+        uint32_t generation;
+    };
+
+    PairingHeap() = default;
+
+    PairingHeap(const PairingHeap &) = delete;
+
+    PairingHeap &operator=(const PairingHeap &) = delete;
+
+    PairingHeap(PairingHeap &&other) noexcept
+            : root(std::exchange(other.root, nullptr)), spare(std::exchange(other.spare, nullptr)),
+              count(std::exchange(other.count, 0)), index_table(std::move(other.index_table)) {}
+
+    PairingHeap &operator=(PairingHeap &&other) noexcept {
+        if (this != &other) {
+            clear();
+            _free_spare();
+            root = std::exchange(other.root, nullptr);
+            spare = std::exchange(other.spare, nullptr);
+            count = std::exchange(other.count, 0);
+            index_table = std::move(other.index_table);
+        }
+        return *this;
+    }
+
+    ~PairingHeap() {
+        clear();
+        _free_spare();
+    }
+
+    Handle add(const K &key, const V &value) {
+        /// метод добавления пары ключ-значение
+        /// возвращает дескриптор элемента
+        /// если ключ уже добавлен в кучу, будет вызвано исключение
+        return add(key, value, key);
+    }
+
+    Handle add(const K &key, const V &value, const K &priority) {
+        /// метод добавления пары ключ-значение с отдельным приоритетом
+        /// возвращает дескриптор элемента
+        /// если ключ уже добавлен в кучу, будет вызвано исключение
+        if constexpr (Indexed) {
+            if (index_table.count(key) != 0) {
+                throw std::logic_error{"This key have already added"};
+            }
+        }
+        auto node = _acquire(key, value, priority);
+        if constexpr (Indexed) {
+            try {
+                index_table.emplace(key, node);
+            } catch (...) {
+                _recycle(node);
+                throw;
+            }
+        }
+        root = _meld(root, node);
+        ++count;
+        return Handle{node, node->generation};
+    }
+
+    Handle find(const K &key) const noexcept {
+        /// метод поиска элемента по ключу
+        /// если ключа нет в куче, будет возвращен недействительный дескриптор
+        auto node = _find(key);
+        return Handle{node, node ? node->generation : 0};
+    }
+
+    [[nodiscard]] bool contains(const Handle handle) const noexcept {
+        /// метод проверки, что элемент с дескриптором handle еще в куче
+        return handle.node && handle.node->generation == handle.generation;
+    }
+
+    Node min() const {
+        /// метод получения минимума без извлечения
+        /// если куча пустая, будет вызвано исключение
+        if (empty()) {
+            throw std::logic_error{"Cannot find min element in empty heap"};
+        }
+        return Node(root->key, root->value, root->priority);
+    }
+
+    V &value(const Handle handle) {
+        /// метод доступа к значению элемента по дескриптору
+        /// если дескриптор недействителен, будет вызвано исключение
+        return _check(handle)->value;
+    }
+
+    const K &priority(const Handle handle) const {
+        /// метод получения приоритета элемента по дескриптору
+        /// если дескриптор недействителен, будет вызвано исключение
+        return _check(handle)->priority;
+    }
+
+    Node extract() {
+        /// метод извлечения минимума (удаление и возвращение функцией)
+        /// если куча пустая, будет вызвано исключение
+        if (empty()) {
+            throw std::logic_error{"Cannot extract from empty heap"};
+        }
+        auto top = root;
+        root = _merge_pairs(top->child);
+        return _release(top);
+    }
+
+    void remove(const K &key) {
+        /// метод удаления элемента по ключу
+        /// если ключа нет в куче, будет вызвано исключение
+        auto node = _find(key);
+        if (!node) {
+            throw std::logic_error{"Cannot remove from empty heap"};
+        }
+        _remove(node);
+    }
+
+    void remove(const Handle handle) {
+        /// метод удаления элемента по дескриптору
+        /// если дескриптор недействителен, будет вызвано исключение
+        _remove(_check(handle));
+    }
+
+    void decrease(const K &key, const K &new_priority) {
+        /// метод уменьшения приоритета элемента по ключу
+        /// если ключа нет в куче или приоритет увеличивается, будет вызвано исключение
+        auto node = _find(key);
+        if (!node) {
+            throw std::logic_error{"Cannot decrease priority of absent key"};
+        }
+        _decrease(node, new_priority);
+    }
+
+    void decrease(const Handle handle, const K &new_priority) {
+        /// метод уменьшения приоритета элемента по дескриптору за O(1): поддерево элемента отрезается
+        /// и подвешивается к корню
+        /// если дескриптор недействителен или приоритет увеличивается, будет вызвано исключение
+        _decrease(_check(handle), new_priority);
+    }
+
+    void update_priority(const K &key, const K &new_priority) {
+        /// метод изменения приоритета элемента по ключу (как в MinHeap)
+        /// если ключа нет в куче, будет вызвано исключение
+        auto node = _find(key);
+        if (!node) {
+            throw std::logic_error{"Cannot update priority of absent key"};
+        }
+        _update(node, new_priority);
+    }
+
+    void update(const Handle handle, const K &new_priority) {
+        /// метод изменения приоритета элемента по дескриптору
+        /// при увеличении приоритета дети элемента отделяются и сливаются с кучей, а сам элемент
+        /// добавляется заново
+        /// если дескриптор недействителен, будет вызвано исключение
+        _update(_check(handle), new_priority);
+    }
+
+    void meld(PairingHeap &other) {
+        /// метод слияния с кучей other: все ее элементы переходят в эту кучу, other становится пустой
+        /// дерево other подвешивается к корню за O(1), дескрипторы элементов other остаются действительными;
+        /// при Indexed = true ключи меньшего индекса проверяются и переносятся в больший
+        /// если в кучах есть одинаковые ключи, будет вызвано исключение, и обе кучи не изменятся
+        if (this == &other || !other.root) {
+            return;
+        }
+        if constexpr (Indexed) {
+            auto *smaller = &other.index_table;
+            auto *larger = &index_table;
+            if (smaller->size() > larger->size()) {
+                std::swap(smaller, larger);
+            }
+            for (auto &entry: *smaller) {
+                if (larger->count(entry.first) != 0) {
+                    throw std::logic_error{"This key have already added"};
+                }
+            }
+            larger->insert(smaller->begin(), smaller->end());
+            if (larger != &index_table) {
+                index_table.swap(*larger);
+            }
+            other.index_table.clear();
+        }
+        root = _meld(root, std::exchange(other.root, nullptr));
+        count += std::exchange(other.count, 0);
+    }
+
+    void clear() noexcept {
+        /// метод удаления всех элементов, их узлы становятся запасными
+        std::vector<PairingNode *> stack;
+        if (root) {
+            stack.push_back(root);
+        }
+        while (!stack.empty()) {
+            auto node = stack.back();
+            stack.pop_back();
+            if (node->child) {
+                stack.push_back(node->child);
+            }
+            if (node->next) {
+                stack.push_back(node->next);
+            }
+            _recycle(node);
+        }
+        root = nullptr;
+        count = 0;
+        if constexpr (Indexed) {
+            index_table.clear();
+        }
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        /// метод проверки, пустая ли куча
+        return !root;
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        /// метод получения числа элементов кучи
+        return count;
+    }
+
+private:
+    PairingNode *root = nullptr;
+    PairingNode *spare = nullptr;  // список запасных узлов, связанный через next
+    size_t count = 0;
+    std::conditional_t<Indexed, std::unordered_map<K, PairingNode *>, NoTable> index_table;  // ключ, узел
+
+    static PairingNode *_link(PairingNode *a, PairingNode *b) noexcept {
+        /// слияние двух деревьев: корень с большим приоритетом становится первым ребенком другого
+        if (b->priority < a->priority) {
+            std::swap(a, b);
+        }
+        b->next = a->child;
+        if (a->child) {
+            a->child->prev = b;
+        }
+        b->prev = a;
+        a->child = b;
+        return a;
+    }
+
+    static PairingNode *_meld(PairingNode *a, PairingNode *b) noexcept {
+        /// слияние деревьев, любое из которых может быть пустым
+        if (!a) {
+            return b;
+        }
+        if (!b) {
+            return a;
+        }
+        return _link(a, b);
+    }
+
+    static PairingNode *_merge_pairs(PairingNode *first) noexcept {
+        /// двухпроходное слияние списка братьев: сначала попарно слева направо (пары складываются в стек
+        /// через next), затем справа налево в одно дерево
+        PairingNode *pairs = nullptr;
+        while (first) {
+            auto a = first;
+            auto b = a->next;
+            first = b ? b->next : nullptr;
+            a->next = a->prev = nullptr;
+            if (b) {
+                b->next = b->prev = nullptr;
+                a = _link(a, b);
+            }
+            a->next = pairs;
+            pairs = a;
+        }
+        PairingNode *result = nullptr;
+        while (pairs) {
+            auto rest = pairs->next;
+            pairs->next = nullptr;
+            result = _meld(result, pairs);
+            pairs = rest;
+        }
+        return result;
+    }
+
+    static void _cut(PairingNode *node) noexcept {
+        /// отделение поддерева node (не корня кучи) от родителя
+        if (node->prev->child == node) {
+            node->prev->child = node->next;
+        } else {
+            node->prev->next = node->next;
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        }
+        node->next = node->prev = nullptr;
+    }
+
+    PairingNode *_find(const K &key) const noexcept {
+        /// узел с ключом key или nullptr
+        static_assert(Indexed, "Lookup by key needs the key index");
+        auto node = index_table.find(key);
+        return node == index_table.end() ? nullptr : node->second;
+    }
+
+    PairingNode *_check(const Handle handle) const {
+        /// проверка дескриптора, возвращает узел
+        if (!contains(handle)) {
+            throw std::logic_error{"Invalid handle"};
+        }
+        return handle.node;
+    }
+
+    PairingNode *_acquire(const K &key, const V &value, const K &priority) {
+        /// новый узел: запасной, если он есть, иначе выделенный
+        if (!spare) {
+            return new PairingNode(key, value, priority);
+        }
+        auto node = spare;
+        node->key = key;
+        node->value = value;
+        node->priority = priority;
+        spare = std::exchange(node->next, nullptr);
+        return node;
+    }
+
+    void _recycle(PairingNode *node) noexcept {
+        /// перевод узла в запасные, дескрипторы узла становятся недействительными
+        ++node->generation;
+        node->child = node->prev = nullptr;
+        node->next = spare;
+        spare = node;
+    }
+
+    void _free_spare() noexcept {
+        /// освобождение запасных узлов
+        while (spare) {
+            delete std::exchange(spare, spare->next);
+        }
+    }
+
+    void _remove(PairingNode *node) {
+        /// удаление элемента кучи
+        if (node == root) {
+            root = _merge_pairs(root->child);
+        } else {
+            _cut(node);
+            root = _meld(root, _merge_pairs(node->child));
+        }
+        _release(node);
+    }
+
+    void _decrease(PairingNode *node, const K &new_priority) {
+        /// уменьшение приоритета элемента кучи
+        if (node->priority < new_priority) {
+            throw std::logic_error{"Cannot increase priority by decrease"};
+        }
+        node->priority = new_priority;
+        if (node != root) {
+            _cut(node);
+            root = _meld(root, node);
+        }
+    }
+
+    void _update(PairingNode *node, const K &new_priority) {
+        /// изменение приоритета элемента кучи
+        if (!(node->priority < new_priority)) {
+            _decrease(node, new_priority);
+            return;
+        }
+        node->priority = new_priority;
+        auto children = std::exchange(node->child, nullptr);
+        if (node == root) {
+            root = _meld(_merge_pairs(children), node);
+        } else {
+            _cut(node);
+            root = _meld(_meld(root, _merge_pairs(children)), node);
+        }
+    }
+
+    Node _release(PairingNode *node) {
+        /// удаление отсоединенного узла, возвращает его содержимое; узел становится запасным
+        Node result(std::move(node->key), std::move(node->value), std::move(node->priority));
+        if constexpr (Indexed) {
+            index_table.erase(result.key);
+        }
+        _recycle(node);
+        --count;
+        return result;
+    }
+};
+
+
+#endif //MINHEAP_PAIRING_HEAP_HPP
@@ -0,0 +1,121 @@
+#ifndef MINHEAP_RADIX_HEAP_HPP
+#define MINHEAP_RADIX_HEAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "minheap.hpp"
+
+
+template<class K = int64_t, class V = std::string>
+class RadixHeap {
+    /// монотонная radix-куча для целых приоритетов: извлекаемые приоритеты не убывают, и добавлять можно только
+    /// приоритеты не меньше последнего извлеченного (last), как в моделировании событий или алгоритме Дейкстры
+    /// элемент лежит в корзине с номером старшего бита, которым его приоритет отличается от last (в корзине 0 -
+    /// равные last); при извлечении из пустой корзины 0 первая непустая корзина просматривается, last становится
+    /// ее минимумом, и элементы раскладываются по корзинам с меньшими номерами
+    /// каждый элемент опускается не больше числа бит приоритета раз, поэтому операции - O(log C) амортизированно
+    /// (C - разброс приоритетов), сравнений при добавлении нет вовсе
+    /// индекса ключей нет: ключи могут повторяться, удаления и изменения приоритета по ключу нет
+    static_assert(std::is_integral_v<K>, "Priorities of radix heap must be integers");
+
+    using U = std::make_unsigned_t<K>;
+    static constexpr size_t Bits = std::numeric_limits<U>::digits;
+
+public:
+    using Node = HeapNode<K, V>;
+
+    void add(const K &key, const V &value) {
+        /// метод добавления пары ключ-значение с приоритетом, равным ключу
+        /// если приоритет меньше последнего извлеченного, будет вызвано исключение
+        add(key, value, key);
+    }
+
+    void add(const K &key, const V &value, const K &priority) {
+        /// метод добавления пары ключ-значение с отдельным приоритетом
+        /// если приоритет меньше последнего извлеченного, будет вызвано исключение
+        auto ordinal = _ordinal(priority);
+        if (ordinal < last) {
+            throw std::logic_error{"Priority is less than last extracted"};
+        }
+        buckets[_bucket(ordinal)].emplace_back(key, value, priority);
+        ++count;
+    }
+
+    Node extract() {
+        /// метод извлечения элемента с минимальным приоритетом
+        /// если куча пустая, будет вызвано исключение
+        if (empty()) {
+            throw std::logic_error{"Cannot extract from empty heap"};
+        }
+        if (buckets[0].empty()) {
+            size_t ind = 1;
+            while (buckets[ind].empty()) {
+                ++ind;
+            }
+            auto &bucket = buckets[ind];
+            last = _ordinal(std::min_element(bucket.begin(), bucket.end(), [](const Node &a, const Node &b) {
+                return a.priority < b.priority;
+            })->priority);
+            for (auto &node: bucket) {
+                buckets[_bucket(_ordinal(node.priority))].push_back(std::move(node));
+            }
+            bucket.clear();
+        }
+        auto top = std::move(buckets[0].back());
+        buckets[0].pop_back();
+        --count;
+        return top;
+    }
+
+    void clear() noexcept {
+        /// метод удаления всех элементов, ограничение на приоритеты снимается
+        for (auto &bucket: buckets) {
+            bucket.clear();
+        }
+        count = 0;
+        last = 0;
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        /// метод проверки, пустая ли куча
+        return !count;
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        /// метод получения числа элементов кучи
+        return count;
+    }
+
+private:
+    std::array<std::vector<Node>, Bits + 1> buckets;
+    size_t count = 0;
+    U last = 0;  // последний извлеченный приоритет в беззнаковом представлении
+
+    [[nodiscard]] static U _ordinal(K priority) noexcept {
+        /// беззнаковое представление с тем же порядком: у знаковых чисел инвертируется знаковый бит
+        auto ordinal = static_cast<U>(priority);
+        if constexpr (std::is_signed_v<K>) {
+            ordinal ^= U(1) << (Bits - 1);
+        }
+        return ordinal;
+    }
+
+    [[nodiscard]] size_t _bucket(U ordinal) const noexcept {
+        /// номер корзины: 0 для равного last, иначе 1 + номер старшего отличающегося бита
+        if (ordinal == last) {
+            return 0;
+        }
+        return static_cast<size_t>(std::numeric_limits<unsigned long long>::digits -
+                                   __builtin_clzll(static_cast<unsigned long long>(ordinal ^ last)));
+    }
+};
+
+
+#endif //MINHEAP_RADIX_HEAP_HPP
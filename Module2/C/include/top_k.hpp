@@ -0,0 +1,153 @@
+#ifndef MINHEAP_TOP_K_HPP
+#define MINHEAP_TOP_K_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cache_aligned_allocator.hpp"
+#include "minheap.hpp"
+
+
+template<class K = int64_t, class V = std::string, size_t Arity = 2>
+class TopK {
+    /// куча фиксированной емкости для отбора K элементов с наибольшими приоритетами из потока
+    /// в корне лежит наименьший из отобранных; новый элемент при заполненной куче либо отбрасывается
+    /// (не больше корня), либо замещает корень и просеивается вниз, поэтому память - O(K), а обработка
+    /// элемента потока - O(1) для отброшенных и O(log K) для принятых
+    /// массив выделяется один раз в конструкторе; далее элементы только перемещаются (память может выделять
+    /// лишь копирование самих K и V при добавлении)
+    /// индекса ключей нет: в потоке ключи могут повторяться
+    static_assert(Arity >= 2, "Arity of heap must be at least 2");
+
+public:
+    using Node = HeapNode<K, V>;
+
+    explicit TopK(size_t capacity) : limit(capacity) {
+        /// если емкость нулевая, будет вызвано исключение
+        if (!capacity) {
+            throw std::logic_error{"Capacity of top-K heap must be positive"};
+        }
+        tape.reserve(capacity);
+    }
+
+    bool add(const K &key, V value) {
+        /// метод добавления элемента потока с приоритетом, равным ключу
+        /// возвращает true, если элемент вошел в K наибольших
+        return add(key, std::move(value), key);
+    }
+
+    bool add(const K &key, V value, const K &priority) {
+        /// метод добавления элемента потока с отдельным приоритетом
+        /// при заполненной куче элемент с приоритетом не больше минимального отбрасывается, иначе вытесняет
+        /// минимальный; возвращает true, если элемент вошел в K наибольших
+        if (tape.size() < limit) {
+            tape.emplace_back(key, std::move(value), priority);
+            _heapify(tape.size() - 1);
+            return true;
+        }
+        if (!(tape.front().priority < priority)) {
+            return false;
+        }
+        tape.front() = Node(key, std::move(value), priority);
+        _sift_down(0);
+        return true;
+    }
+
+    const Node &min() const {
+        /// метод получения наименьшего из отобранных элементов (порога отбора)
+        /// если куча пустая, будет вызвано исключение
+        if (tape.empty()) {
+            throw std::logic_error{"Cannot find min element in empty heap"};
+        }
+        return tape.front();
+    }
+
+    template<class It>
+    It drain_sorted(It out) {
+        /// метод выдачи отобранных элементов по убыванию приоритета в итератор out
+        /// массив сортируется на месте (пирамидальная сортировка: корень уходит в конец), затем элементы
+        /// перемещаются в out; куча становится пустой, емкость сохраняется
+        /// возвращает итератор за последним записанным элементом
+        for (auto size = tape.size(); size > 1; --size) {
+            std::swap(tape.front(), tape[size - 1]);
+            _sift_down(0, size - 1);
+        }
+        for (auto &node: tape) {
+            *out++ = std::move(node);
+        }
+        tape.clear();
+        return out;
+    }
+
+    std::vector<Node> drain_sorted() {
+        /// метод выдачи отобранных элементов по убыванию приоритета в новый вектор
+        std::vector<Node> result;
+        result.reserve(tape.size());
+        drain_sorted(std::back_inserter(result));
+        return result;
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        /// метод проверки, пустая ли куча
+        return tape.empty();
+    }
+
+    [[nodiscard]] inline size_t size() const noexcept {
+        /// метод получения числа отобранных элементов
+        return tape.size();
+    }
+
+    [[nodiscard]] inline size_t capacity() const noexcept {
+        /// метод получения емкости K
+        return limit;
+    }
+
+private:
+    std::vector<Node, CacheAlignedAllocator<Node, Arity - 1>> tape;
+    size_t limit;
+
+    void _heapify(size_t ind) noexcept {
+        /// просеивание вверх
+        auto node = std::move(tape[ind]);
+        while (ind) {
+            auto parent = (ind - 1) / Arity;
+            if (!(node.priority < tape[parent].priority)) {
+                break;
+            }
+            tape[ind] = std::move(tape[parent]);
+            ind = parent;
+        }
+        tape[ind] = std::move(node);
+    }
+
+    void _sift_down(size_t ind) noexcept {
+        _sift_down(ind, tape.size());
+    }
+
+    void _sift_down(size_t ind, size_t size) noexcept {
+        /// просеивание вниз в пределах первых size элементов
+        auto node = std::move(tape[ind]);
+        for (auto first = Arity * ind + 1; first < size; first = Arity * ind + 1) {
+            auto last = std::min(first + Arity, size);
+            auto child = first;
+            for (auto i = first + 1; i < last; ++i) {
+                if (tape[i].priority < tape[child].priority) {
+                    child = i;
+                }
+            }
+            if (!(tape[child].priority < node.priority)) {
+                break;
+            }
+            tape[ind] = std::move(tape[child]);
+            ind = child;
+        }
+        tape[ind] = std::move(node);
+    }
+};
+
+
+#endif //MINHEAP_TOP_K_HPP
@@ -1,8 +1,20 @@
 #include <fstream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <unordered_map>
 
 #include <gtest/gtest.h>
 
 #include "minheap.hpp"
+#include "fixed_minheap.hpp"
+#include "minmax_heap.hpp"
+#include "multiqueue.hpp"
+#include "pairing_heap.hpp"
+#include "radix_heap.hpp"
+#include "top_k.hpp"
 
 using Node = typename MinHeap<int64_t, std::string>::Node;
 
@@ -121,6 +133,782 @@ TEST(MinHeap_Test, Max_extract) {
     EXPECT_TRUE(mhp.empty());
 }
 
+TEST(MinHeap_Test, Min_max_heap) {
+    MinMaxHeap<> mmh;
+    EXPECT_THROW(mmh.max(), std::logic_error);
+    EXPECT_THROW(mmh.extract_max(), std::logic_error);
+
+    std::map<int64_t, std::string> oracle;
+    std::mt19937 generator(14);
+    for (int i = 0; i < 20000; ++i) {
+        auto key = static_cast<int64_t>(generator() % 3000) - 1500;
+        switch (generator() % 5) {
+            case 0:
+            case 1:
+                if (oracle.count(key)) {
+                    ASSERT_THROW(mmh.add(key, ""), std::logic_error);
+                } else {
+                    mmh.add(key, std::to_string(i));
+                    oracle.emplace(key, std::to_string(i));
+                }
+                break;
+            case 2:
+                if (oracle.count(key)) {
+                    mmh.remove(key);
+                    oracle.erase(key);
+                } else {
+                    ASSERT_THROW(mmh.remove(key), std::logic_error);
+                }
+                break;
+            case 3:
+                if (!oracle.empty()) {
+                    ASSERT_EQ(mmh.extract_min(), Node(oracle.begin()->first, oracle.begin()->second));
+                    oracle.erase(oracle.begin());
+                }
+                break;
+            default:
+                if (!oracle.empty()) {
+                    ASSERT_EQ(mmh.extract_max(), Node(oracle.rbegin()->first, oracle.rbegin()->second));
+                    oracle.erase(std::prev(oracle.end()));
+                }
+        }
+        ASSERT_EQ(mmh.size(), oracle.size());
+        if (!oracle.empty()) {
+            ASSERT_EQ(mmh.min().key, oracle.begin()->first);
+            ASSERT_EQ(mmh.max().key, oracle.rbegin()->first);
+            ASSERT_EQ(mmh.at(mmh.max_index()).key, oracle.rbegin()->first);
+        }
+    }
+    for (auto &item: oracle) {
+        ASSERT_EQ(mmh.at(mmh.index(item.first)), Node(item.first, item.second));
+    }
+
+    std::stringstream commands("add 5 a\nadd 1 b\nadd 9 c\nadd 3 d\nmin\nmax\nextract\ndelete 9\nmax\nprint\n");
+    std::stringstream out;
+    handler<std::stringstream, std::stringstream, MinMaxHeap<>>(commands, out);
+    EXPECT_EQ(out.str(), "1 0 b\n9 2 c\n1 b\n5 1 a\n[3 d]\n[5 a 3] _\n");
+}
+
+TEST(MinHeap_Test, Update_priority) {
+    MinHeap<> mhp;
+    EXPECT_THROW(mhp.update_priority(1, 0), std::logic_error);
+    for (int64_t i = 0; i < 10; ++i) {
+        mhp.add(i, std::to_string(i), 100 + 10 * i);
+    }
+    mhp.update_priority(7, 0);
+    mhp.update_priority(0, 1000);
+    mhp.update_priority(5, 135);
+    EXPECT_EQ(mhp.at(mhp.index(7)).priority, 0);
+    EXPECT_EQ(mhp.index(7), 0);
+    EXPECT_EQ(mhp.max(), Node(0, "0"));
+    std::vector<int64_t> order;
+    while (!mhp.empty()) {
+        order.push_back(mhp.extract().key);
+    }
+    EXPECT_EQ(order, std::vector<int64_t>({7, 1, 2, 3, 5, 4, 6, 8, 9, 0}));
+
+    // алгоритм Дейкстры на случайном графе: ключ - вершина, приоритет - расстояние
+    const int64_t vertices = 300;
+    std::mt19937 generator(15);
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> graph(vertices);
+    for (int i = 0; i < 3000; ++i) {
+        auto from = static_cast<int64_t>(generator() % vertices);
+        auto to = static_cast<int64_t>(generator() % vertices);
+        graph[from].emplace_back(to, static_cast<int64_t>(generator() % 100));
+    }
+    const int64_t infinity = std::numeric_limits<int64_t>::max();
+    std::vector<int64_t> expected(vertices, infinity);
+    expected[0] = 0;
+    for (int64_t round = 0; round < vertices; ++round) {
+        for (int64_t from = 0; from < vertices; ++from) {
+            for (auto &edge: graph[from]) {
+                if (expected[from] != infinity && expected[from] + edge.second < expected[edge.first]) {
+                    expected[edge.first] = expected[from] + edge.second;
+                }
+            }
+        }
+    }
+    std::vector<int64_t> distance(vertices, infinity);
+    distance[0] = 0;
+    MinHeap<int64_t, std::string> queue;
+    queue.add(0, "", 0);
+    while (!queue.empty()) {
+        auto top = queue.extract();
+        for (auto &edge: graph[top.key]) {
+            auto candidate = top.priority + edge.second;
+            if (candidate < distance[edge.first]) {
+                if (distance[edge.first] == infinity) {
+                    queue.add(edge.first, "", candidate);
+                } else {
+                    queue.update_priority(edge.first, candidate);
+                }
+                distance[edge.first] = candidate;
+            }
+        }
+    }
+    EXPECT_EQ(distance, expected);
+}
+
+template<size_t Arity, class Index = FlatIndex<int64_t, uint32_t>>
+void check_arity() {
+    MinHeap<int64_t, std::string, Arity, Index> mhp;
+    std::map<int64_t, int64_t> priorities;  // ключ, приоритет
+    std::mt19937 generator(Arity);
+    for (int i = 0; i < 20000; ++i) {
+        auto key = static_cast<int64_t>(generator() % 2000);
+        auto priority = static_cast<int64_t>(generator() % 1000000);
+        auto found = priorities.find(key);
+        switch (generator() % 4) {
+            case 0:
+            case 1:
+                if (found == priorities.end()) {
+                    mhp.add(key, std::to_string(key), priority);
+                    priorities.emplace(key, priority);
+                } else {
+                    mhp.update_priority(key, priority);
+                    found->second = priority;
+                }
+                break;
+            case 2:
+                if (found == priorities.end()) {
+                    ASSERT_THROW(mhp.remove(key), std::logic_error);
+                } else {
+                    mhp.remove(key);
+                    priorities.erase(found);
+                }
+                break;
+            default:
+                if (!priorities.empty()) {
+                    auto top = mhp.extract();
+                    ASSERT_EQ(top.value, std::to_string(top.key));
+                    ASSERT_EQ(top.priority, priorities.at(top.key));
+                    for (auto &item: priorities) {
+                        ASSERT_LE(top.priority, item.second);
+                    }
+                    priorities.erase(top.key);
+                }
+        }
+        ASSERT_EQ(mhp.size(), priorities.size());
+    }
+    for (auto &item: priorities) {
+        ASSERT_EQ(mhp.at(mhp.index(item.first)).priority, item.second);
+    }
+}
+
+TEST(MinHeap_Test, Arity) {
+    check_arity<3>();
+    check_arity<4>();
+    check_arity<8>();
+
+    MinHeap<int64_t, std::string, 4> mhp;
+    for (int64_t i = 1; i <= 7; ++i) {
+        mhp.add(i, std::to_string(i));
+    }
+    std::stringstream out;
+    out << mhp;
+    EXPECT_EQ(out.str(), "[1 1]\n[2 2 1] [3 3 1] [4 4 1] [5 5 1]\n[6 6 2] [7 7 2] _ _ _ _ _ _ _ _ _ _ _ _ _ _");
+    EXPECT_EQ(mhp.max(), Node(7, "7"));
+    EXPECT_EQ(mhp.max_index(), 6);
+}
+
+TEST(MinHeap_Test, Stable_slots) {
+    MinHeap<int64_t, std::string> mhp;
+    for (int64_t i = 100; i > 0; --i) {
+        mhp.add(i, std::to_string(i));
+    }
+    auto *value = &mhp.at(mhp.index(50)).value;
+    for (int64_t i = 100; i > 60; --i) {
+        mhp.update_priority(i, i - 100);
+    }
+    for (int i = 0; i < 40; ++i) {
+        mhp.extract();
+    }
+    EXPECT_EQ(&mhp.at(mhp.index(50)).value, value);
+    EXPECT_EQ(*value, "50");
+
+    mhp.at(mhp.index(50)).value = "fifty";
+    mhp.update_priority(50, 0);
+    EXPECT_EQ(mhp.index(50), 0);
+    EXPECT_EQ(mhp.extract(), Node(50, "fifty", 0));
+
+    mhp.add(200, "200");
+    EXPECT_EQ(&mhp.at(mhp.index(200)).value, value);
+    EXPECT_EQ(mhp.size(), 60);
+}
+
+TEST(MinHeap_Test, Index) {
+    FlatIndex<int64_t> flat;
+    DenseIndex<int64_t> dense;
+    std::unordered_map<int64_t, uint32_t> expected;
+    std::mt19937 generator(18);
+    for (uint32_t i = 0; i < 100000; ++i) {
+        auto key = static_cast<int64_t>(generator() % 5000);
+        if (generator() % 2) {
+            auto added = expected.emplace(key, i).second;
+            ASSERT_EQ(flat.emplace(key, i), added);
+            ASSERT_EQ(dense.emplace(key, i), added);
+        } else {
+            auto erased = expected.erase(key) != 0;
+            ASSERT_EQ(flat.erase(key), erased);
+            ASSERT_EQ(dense.erase(key), erased);
+        }
+        ASSERT_EQ(flat.size(), expected.size());
+        ASSERT_EQ(dense.size(), expected.size());
+    }
+    for (int64_t key = -1; key < 5001; ++key) {
+        auto found = expected.find(key);
+        if (found == expected.end()) {
+            EXPECT_EQ(flat.find(key), nullptr);
+            EXPECT_EQ(dense.find(key), nullptr);
+        } else {
+            ASSERT_NE(flat.find(key), nullptr);
+            ASSERT_NE(dense.find(key), nullptr);
+            EXPECT_EQ(*flat.find(key), found->second);
+            EXPECT_EQ(*dense.find(key), found->second);
+        }
+    }
+    EXPECT_THROW(dense.emplace(-1, 0), std::out_of_range);
+    EXPECT_THROW(flat.emplace(1, FlatIndex<int64_t>::Empty), std::out_of_range);
+
+    check_arity<2, DenseIndex<int64_t>>();
+    check_arity<4, DenseIndex<int64_t>>();
+    MinHeap<std::string, std::string> strings;
+    strings.add("b", "2");
+    strings.add("a", "1");
+    EXPECT_THROW(strings.add("a", "3"), std::logic_error);
+    EXPECT_EQ(strings.index("a"), 0);
+    EXPECT_EQ(strings.extract().value, "1");
+}
+
+TEST(MinHeap_Test, Handles) {
+    using Heap = MinHeap<int64_t, std::string>;
+    Heap mhp;
+    std::vector<Heap::Handle> handles;
+    for (int64_t i = 0; i < 10; ++i) {
+        handles.push_back(mhp.add(i, std::to_string(i), 100 + 10 * i));
+    }
+    EXPECT_EQ(mhp.value(handles[3]), "3");
+    mhp.value(handles[3]) = "three";
+    EXPECT_EQ(mhp.at(mhp.index(3)).value, "three");
+    mhp.update(handles[9], 0);
+    EXPECT_EQ(mhp.index(handles[9]), 0);
+    EXPECT_EQ(mhp.index(handles[9]), mhp.index(9));
+    mhp.remove(handles[0]);
+    EXPECT_EQ(mhp.index(0), -1);
+    EXPECT_FALSE(mhp.contains(handles[0]));
+    EXPECT_EQ(mhp.index(handles[0]), -1);
+    EXPECT_THROW(mhp.remove(handles[0]), std::logic_error);
+    EXPECT_THROW(mhp.value(handles[0]), std::logic_error);
+    EXPECT_THROW(mhp.update(handles[0], 1), std::logic_error);
+
+    auto reused = mhp.add(0, "zero");  // занимает освобожденную ячейку
+    EXPECT_EQ(reused.slot, handles[0].slot);
+    EXPECT_FALSE(mhp.contains(handles[0]));
+    EXPECT_EQ(mhp.value(reused), "zero");
+    EXPECT_EQ(mhp.extract(), Node(9, "9"));
+    EXPECT_FALSE(mhp.contains(handles[9]));
+    EXPECT_EQ(mhp.extract(), Node(0, "zero"));
+    EXPECT_TRUE(mhp.contains(handles[1]));
+
+    // алгоритм Дейкстры только через дескрипторы, без индекса ключей
+    const int64_t vertices = 300;
+    std::mt19937 generator(19);
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> graph(vertices);
+    for (int i = 0; i < 3000; ++i) {
+        auto from = static_cast<int64_t>(generator() % vertices);
+        auto to = static_cast<int64_t>(generator() % vertices);
+        graph[from].emplace_back(to, static_cast<int64_t>(generator() % 100));
+    }
+    const int64_t infinity = std::numeric_limits<int64_t>::max();
+    std::vector<int64_t> expected(vertices, infinity);
+    MinHeap<int64_t, std::string> keyed;
+    expected[0] = 0;
+    keyed.add(0, "", 0);
+    while (!keyed.empty()) {
+        auto top = keyed.extract();
+        for (auto &edge: graph[top.key]) {
+            auto candidate = top.priority + edge.second;
+            if (candidate < expected[edge.first]) {
+                if (expected[edge.first] == infinity) {
+                    keyed.add(edge.first, "", candidate);
+                } else {
+                    keyed.update_priority(edge.first, candidate);
+                }
+                expected[edge.first] = candidate;
+            }
+        }
+    }
+    using Queue = MinHeap<int64_t, std::string, 2, NoIndex<int64_t>>;
+    Queue queue;
+    std::vector<int64_t> distance(vertices, infinity);
+    std::vector<Queue::Handle> vertex_handles(vertices);
+    distance[0] = 0;
+    vertex_handles[0] = queue.add(0, "", 0);
+    while (!queue.empty()) {
+        auto top = queue.extract();
+        for (auto &edge: graph[top.key]) {
+            auto candidate = top.priority + edge.second;
+            if (candidate < distance[edge.first]) {
+                if (distance[edge.first] == infinity) {
+                    vertex_handles[edge.first] = queue.add(edge.first, "", candidate);
+                } else {
+                    queue.update(vertex_handles[edge.first], candidate);
+                }
+                distance[edge.first] = candidate;
+            }
+        }
+    }
+    EXPECT_EQ(distance, expected);
+    EXPECT_EQ(queue.index(0), -1);
+}
+
+template<size_t Arity>
+void check_build() {
+    MinHeap<int64_t, std::string, Arity> mhp;
+    std::vector<Node> nodes;
+    std::mt19937 generator(Arity);
+    for (int64_t i = 0; i < 5000; ++i) {
+        nodes.emplace_back(i, std::to_string(i), static_cast<int64_t>(generator() % 1000));
+    }
+    mhp.add(-1, "old");
+    mhp.build(nodes.begin(), nodes.end());
+    ASSERT_EQ(mhp.size(), nodes.size());
+    EXPECT_EQ(mhp.index(-1), -1);
+    for (auto &node: nodes) {
+        ASSERT_EQ(mhp.at(mhp.index(node.key)), node);
+    }
+
+    std::vector<Node> small = {Node(-1, "a", 500), Node(-2, "b", -5)};
+    mhp.add_batch(small);
+    EXPECT_EQ(mhp.index(-2), 0);
+    std::vector<Node> large;
+    for (int64_t i = 5000; i < 20000; ++i) {
+        large.emplace_back(i, std::to_string(i), static_cast<int64_t>(generator() % 1000));
+    }
+    mhp.add_batch(large.begin(), large.end());
+
+    std::vector<Node> duplicate = {Node(-3, "c", -10), Node(7, "7")};
+    EXPECT_THROW(mhp.add_batch(duplicate), std::logic_error);
+    duplicate.push_back(duplicate.front());
+    EXPECT_THROW(mhp.build(duplicate.begin(), duplicate.end()), std::logic_error);
+    EXPECT_EQ(mhp.index(-3), -1);
+    ASSERT_EQ(mhp.size(), 20002);
+
+    std::map<int64_t, std::set<int64_t>> expected;  // приоритет, ключи
+    for (auto *part: {&nodes, &small, &large}) {
+        for (auto &node: *part) {
+            expected[node.priority].insert(node.key);
+        }
+    }
+    expected[500].insert(-1);
+    for (auto &group: expected) {
+        for (size_t n = group.second.size(); n; --n) {
+            auto top = mhp.extract();
+            ASSERT_EQ(top.priority, group.first);
+            ASSERT_EQ(group.second.count(top.key), 1);
+        }
+    }
+    EXPECT_TRUE(mhp.empty());
+}
+
+TEST(MinHeap_Test, Build) {
+    check_build<2>();
+    check_build<4>();
+    MinHeap<> mhp;
+    std::vector<Node> nodes;
+    mhp.build(nodes.begin(), nodes.end());
+    EXPECT_TRUE(mhp.empty());
+    nodes.emplace_back(1, "1");
+    mhp.build(nodes.begin(), nodes.end());
+    EXPECT_EQ(mhp.extract(), Node(1, "1"));
+}
+
+TEST(MinHeap_Test, Pairing_heap) {
+    PairingHeap<int64_t, std::string> php;
+    EXPECT_TRUE(php.empty());
+    EXPECT_THROW(php.extract(), std::logic_error);
+    EXPECT_THROW(php.min(), std::logic_error);
+    std::map<int64_t, int64_t> priorities;  // ключ, приоритет
+    std::mt19937 generator(21);
+    for (int i = 0; i < 20000; ++i) {
+        auto key = static_cast<int64_t>(generator() % 2000);
+        auto priority = static_cast<int64_t>(generator() % 1000000);
+        auto found = priorities.find(key);
+        switch (generator() % 5) {
+            case 0:
+            case 1:
+                if (found == priorities.end()) {
+                    php.add(key, std::to_string(key), priority);
+                    priorities.emplace(key, priority);
+                } else {
+                    ASSERT_THROW(php.add(key, ""), std::logic_error);
+                    php.update_priority(key, priority);
+                    found->second = priority;
+                }
+                break;
+            case 2:
+                if (found == priorities.end()) {
+                    ASSERT_THROW(php.remove(key), std::logic_error);
+                } else {
+                    php.remove(key);
+                    priorities.erase(found);
+                }
+                break;
+            case 3:
+                if (found != priorities.end()) {
+                    ASSERT_THROW(php.decrease(key, found->second + 1), std::logic_error);
+                    php.decrease(key, found->second / 2);
+                    found->second /= 2;
+                }
+                break;
+            default:
+                if (!priorities.empty()) {
+                    auto top = php.extract();
+                    ASSERT_EQ(top.value, std::to_string(top.key));
+                    ASSERT_EQ(priorities.at(top.key), top.priority);
+                    for (auto &item: priorities) {
+                        ASSERT_FALSE(item.second < top.priority);
+                    }
+                    priorities.erase(top.key);
+                }
+        }
+        ASSERT_EQ(php.size(), priorities.size());
+    }
+    for (auto &item: priorities) {
+        ASSERT_TRUE(php.contains(php.find(item.first)));
+        EXPECT_EQ(php.priority(php.find(item.first)), item.second);
+    }
+
+    // слияние куч нескольких потоков
+    std::vector<PairingHeap<int64_t, std::string>> workers(4);
+    std::vector<PairingHeap<int64_t, std::string>::Handle> handles;
+    for (int64_t i = 0; i < 400; ++i) {
+        handles.push_back(workers[i % 4].add(i, std::to_string(i), (i * 37) % 400));
+    }
+    PairingHeap<int64_t, std::string> merged;
+    for (auto &worker: workers) {
+        merged.meld(worker);
+        EXPECT_TRUE(worker.empty());
+    }
+    EXPECT_EQ(merged.size(), 400);
+    merged.decrease(handles[399], -1);
+    EXPECT_EQ(merged.find(399).node, handles[399].node);
+    merged.value(handles[5]) = "five";
+    PairingHeap<int64_t, std::string> clash;
+    clash.add(3, "3");
+    EXPECT_THROW(merged.meld(clash), std::logic_error);
+    EXPECT_EQ(clash.size(), 1);
+    EXPECT_EQ(merged.size(), 400);
+    EXPECT_EQ(merged.extract(), Node(399, "399"));
+    std::vector<int64_t> order;
+    while (!merged.empty()) {
+        auto top = merged.extract();
+        order.push_back(top.priority);
+        if (top.key == 5) {
+            EXPECT_EQ(top.value, "five");
+        }
+    }
+    std::vector<int64_t> expected;
+    for (int64_t priority = 0; priority < 400; ++priority) {
+        if (priority != 399 * 37 % 400) {
+            expected.push_back(priority);
+        }
+    }
+    EXPECT_EQ(order, expected);
+
+    PairingHeap<int64_t, std::string, false> first;
+    PairingHeap<int64_t, std::string, false> second;
+    auto handle = first.add(1, "1", 10);
+    second.add(1, "1 again", 5);
+    first.meld(second);
+    first.update(handle, 1);
+    EXPECT_EQ(first.extract(), Node(1, "1"));
+    EXPECT_EQ(first.extract(), Node(1, "1 again"));
+    EXPECT_TRUE(first.empty());
+
+    // ключ 0 не путается с дескриптором, удаленный элемент не доступен по старому дескриптору
+    PairingHeap<> zero;
+    auto stale = zero.add(0, "0", 5);
+    zero.add(1, "1", 7);
+    zero.decrease(0, 3);
+    EXPECT_EQ(zero.min(), Node(0, "0", 3));
+    zero.remove(0);
+    EXPECT_FALSE(zero.contains(stale));
+    EXPECT_FALSE(zero.contains(zero.find(0)));
+    EXPECT_THROW(zero.remove(stale), std::logic_error);
+    EXPECT_THROW(zero.decrease(stale, 0), std::logic_error);
+    EXPECT_THROW(zero.value(stale), std::logic_error);
+    auto reused = zero.add(2, "2");
+    EXPECT_TRUE(zero.contains(reused));
+    EXPECT_FALSE(zero.contains(stale));
+    zero.clear();
+    EXPECT_FALSE(zero.contains(reused));
+    EXPECT_THROW(zero.update(reused, 0), std::logic_error);
+}
+
+TEST(MinHeap_Test, Top_k) {
+    EXPECT_THROW(TopK<>(0), std::logic_error);
+    TopK<int64_t, std::string, 4> top(100);
+    EXPECT_THROW(top.min(), std::logic_error);
+    std::vector<int64_t> scores;
+    std::mt19937 generator(22);
+    for (int64_t i = 0; i < 100000; ++i) {
+        auto score = static_cast<int64_t>(generator() % 1000000);
+        scores.push_back(score);
+        top.add(i, std::to_string(i), score);
+        ASSERT_EQ(top.size(), std::min<size_t>(i + 1, 100));
+    }
+    std::sort(scores.rbegin(), scores.rend());
+    EXPECT_EQ(top.min().priority, scores[99]);
+    EXPECT_FALSE(top.add(-1, "", scores[99]));
+    auto result = top.drain_sorted();
+    EXPECT_TRUE(top.empty());
+    ASSERT_EQ(result.size(), 100);
+    for (size_t i = 0; i < result.size(); ++i) {
+        EXPECT_EQ(result[i].priority, scores[i]);
+        EXPECT_EQ(result[i].value, std::to_string(result[i].key));
+    }
+
+    TopK<> few(5);
+    for (int64_t key: {3, 1, 2}) {
+        few.add(key, std::to_string(key));
+    }
+    std::vector<Node> out(3);
+    EXPECT_EQ(few.drain_sorted(out.begin()), out.end());
+    EXPECT_EQ(out, std::vector<Node>({Node(3, "3"), Node(2, "2"), Node(1, "1")}));
+    EXPECT_EQ(few.capacity(), 5);
+    EXPECT_TRUE(few.add(7, "7"));
+    EXPECT_EQ(few.min(), Node(7, "7"));
+}
+
+TEST(MinHeap_Test, Multiqueue) {
+    EXPECT_THROW(MultiQueue<>(0), std::logic_error);
+    MultiQueue<int64_t, std::string> queue(2, 2);
+    EXPECT_EQ(queue.shard_count(), 4);
+    EXPECT_THROW(queue.extract(), std::logic_error);
+
+    // ранг ошибки при последовательной работе: число элементов очереди с меньшим приоритетом
+    std::multiset<int64_t> present;
+    std::mt19937 generator(23);
+    size_t total_rank = 0;
+    size_t extracted = 0;
+    for (int64_t i = 0; i < 20000; ++i) {
+        if (present.empty() || generator() % 2) {
+            auto priority = static_cast<int64_t>(generator() % 1000000);
+            queue.add(i, std::to_string(i), priority);
+            present.insert(priority);
+        } else {
+            auto top = queue.extract();
+            ASSERT_EQ(top.value, std::to_string(top.key));
+            auto found = present.find(top.priority);
+            ASSERT_NE(found, present.end());
+            total_rank += static_cast<size_t>(std::distance(present.begin(), present.lower_bound(top.priority)));
+            present.erase(found);
+            ++extracted;
+        }
+        ASSERT_EQ(queue.size(), present.size());
+    }
+    EXPECT_LT(static_cast<double>(total_rank) / static_cast<double>(extracted), 4.0 * queue.shard_count());
+
+    // одновременные добавления и извлечения: каждый элемент извлекается ровно один раз
+    // с одним шардом все потоки делят одну блокировку, и добавление и извлечение уходят в ожидание
+    const int64_t threads = 4;
+    const int64_t per_thread = 5000;
+    for (bool single: {false, true}) {
+        MultiQueue<int64_t, int64_t> shared(single ? 1 : threads, single ? 1 : 2);
+        std::vector<std::vector<int64_t>> taken(threads);
+        std::vector<std::thread> workers;
+        for (int64_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&shared, &taken, t, per_thread] {
+                HeapNode<int64_t, int64_t> node;
+                for (int64_t i = t * per_thread; i < (t + 1) * per_thread; ++i) {
+                    shared.add(i, i, i % 1000);
+                    if (i % 2 && shared.try_extract(node)) {
+                        taken[t].push_back(node.key);
+                    }
+                }
+            });
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        std::vector<int64_t> keys;
+        for (auto &part: taken) {
+            keys.insert(keys.end(), part.begin(), part.end());
+        }
+        while (!shared.empty()) {
+            keys.push_back(shared.extract().key);
+        }
+        std::sort(keys.begin(), keys.end());
+        ASSERT_EQ(keys.size(), threads * per_thread);
+        for (int64_t i = 0; i < threads * per_thread; ++i) {
+            ASSERT_EQ(keys[i], i);
+        }
+    }
+}
+
+template<class K>
+void check_radix(K low, K high) {
+    RadixHeap<K, std::string> rhp;
+    std::multiset<K> present;
+    std::mt19937_64 generator(24);
+    std::uniform_int_distribution<K> uniform(low, high);
+    K last = low;
+    for (int i = 0; i < 20000; ++i) {
+        if (present.empty() || generator() % 2) {
+            auto priority = std::max(last, uniform(generator));
+            rhp.add(static_cast<K>(i), std::to_string(i), priority);
+            present.insert(priority);
+        } else {
+            auto top = rhp.extract();
+            ASSERT_EQ(top.priority, *present.begin());
+            ASSERT_EQ(top.value, std::to_string(top.key));
+            present.erase(present.begin());
+            last = top.priority;
+        }
+        ASSERT_EQ(rhp.size(), present.size());
+    }
+    if (last != low) {
+        EXPECT_THROW(rhp.add(0, "", static_cast<K>(last - 1)), std::logic_error);
+    }
+}
+
+TEST(MinHeap_Test, Radix_heap) {
+    check_radix<int64_t>(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
+    check_radix<int64_t>(-1000, 1000);
+    check_radix<uint32_t>(0, std::numeric_limits<uint32_t>::max());
+    check_radix<uint64_t>(0, 100);
+
+    RadixHeap<> rhp;
+    EXPECT_THROW(rhp.extract(), std::logic_error);
+    rhp.add(5, "5");
+    rhp.add(3, "3");
+    rhp.add(5, "five", 4);
+    EXPECT_EQ(rhp.extract(), Node(3, "3"));
+    EXPECT_EQ(rhp.extract().value, "five");
+    EXPECT_THROW(rhp.add(2, "2"), std::logic_error);
+    rhp.clear();
+    rhp.add(2, "2");
+    EXPECT_EQ(rhp.extract(), Node(2, "2"));
+
+    // алгоритм Дейкстры с целыми весами: вершины с устаревшим расстоянием пропускаются при извлечении
+    const int64_t vertices = 300;
+    std::mt19937 generator(24);
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> graph(vertices);
+    for (int i = 0; i < 3000; ++i) {
+        auto from = static_cast<int64_t>(generator() % vertices);
+        auto to = static_cast<int64_t>(generator() % vertices);
+        graph[from].emplace_back(to, static_cast<int64_t>(generator() % 100));
+    }
+    const int64_t infinity = std::numeric_limits<int64_t>::max();
+    std::vector<int64_t> expected(vertices, infinity);
+    MinHeap<int64_t, std::string> keyed;
+    expected[0] = 0;
+    keyed.add(0, "", 0);
+    while (!keyed.empty()) {
+        auto top = keyed.extract();
+        for (auto &edge: graph[top.key]) {
+            auto candidate = top.priority + edge.second;
+            if (candidate < expected[edge.first]) {
+                if (expected[edge.first] == infinity) {
+                    keyed.add(edge.first, "", candidate);
+                } else {
+                    keyed.update_priority(edge.first, candidate);
+                }
+                expected[edge.first] = candidate;
+            }
+        }
+    }
+    std::vector<int64_t> distance(vertices, infinity);
+    RadixHeap<int64_t, std::string> queue;
+    distance[0] = 0;
+    queue.add(0, "", 0);
+    while (!queue.empty()) {
+        auto top = queue.extract();
+        if (top.priority != distance[top.key]) {
+            continue;
+        }
+        for (auto &edge: graph[top.key]) {
+            auto candidate = top.priority + edge.second;
+            if (candidate < distance[edge.first]) {
+                distance[edge.first] = candidate;
+                queue.add(edge.first, "", candidate);
+            }
+        }
+    }
+    EXPECT_EQ(distance, expected);
+}
+
+constexpr int64_t fixed_heap_order() {
+    FixedMinHeap<int64_t, int64_t, 4> heap;
+    heap.add(5, 50);
+    heap.add(3, 30);
+    heap.add(7, 70);
+    heap.update_priority(7, 1);
+    heap.remove(3);
+    heap.add(2, 20);
+    int64_t order = 0;
+    while (!heap.empty()) {
+        order = 10 * order + heap.extract().key;
+    }
+    return order;
+}
+
+TEST(MinHeap_Test, Fixed_heap) {
+    static_assert(fixed_heap_order() == 725);
+
+    FixedMinHeap<int64_t, std::string, 100> mhp;
+    EXPECT_EQ(mhp.capacity(), 100);
+    EXPECT_THROW(mhp.extract(), std::logic_error);
+    EXPECT_THROW(mhp.min(), std::logic_error);
+    std::map<int64_t, int64_t> priorities;  // ключ, приоритет
+    std::mt19937 generator(25);
+    for (int i = 0; i < 50000; ++i) {
+        auto key = static_cast<int64_t>(generator() % 300);
+        auto priority = static_cast<int64_t>(generator() % 1000000);
+        auto found = priorities.find(key);
+        switch (generator() % 4) {
+            case 0:
+            case 1:
+                if (found != priorities.end()) {
+                    ASSERT_THROW(mhp.add(key, ""), std::logic_error);
+                    mhp.update_priority(key, priority);
+                    found->second = priority;
+                } else if (mhp.full()) {
+                    ASSERT_FALSE(mhp.try_add(key, "", priority));
+                    ASSERT_THROW(mhp.add(key, ""), std::length_error);
+                } else {
+                    mhp.add(key, std::to_string(key), priority);
+                    priorities.emplace(key, priority);
+                }
+                break;
+            case 2:
+                if (found == priorities.end()) {
+                    ASSERT_THROW(mhp.remove(key), std::logic_error);
+                    ASSERT_EQ(mhp.index(key), -1);
+                } else {
+                    mhp.remove(key);
+                    priorities.erase(found);
+                }
+                break;
+            default:
+                if (!priorities.empty()) {
+                    auto top = mhp.extract();
+                    ASSERT_EQ(top.value, std::to_string(top.key));
+                    ASSERT_EQ(priorities.at(top.key), top.priority);
+                    for (auto &item: priorities) {
+                        ASSERT_FALSE(item.second < top.priority);
+                    }
+                    priorities.erase(top.key);
+                }
+        }
+        ASSERT_EQ(mhp.size(), priorities.size());
+    }
+    for (auto &item: priorities) {
+        ASSERT_NE(mhp.index(item.first), -1);
+    }
+}
+
 TEST(MinHeap_Test, Handler) {
     std::stringstream out_stream;
     std::stringstream answer_stream;